@@ -0,0 +1,242 @@
+#include <cassert>
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+constexpr int SIZE = 64;
+constexpr double tol = 1.0E-6;
+
+// prints the device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// sets a usage flag from inside a kernel
+template<typename Usage_type>
+void set_flag(const Usage_type& usage, size_t i){
+  sycl::atomic_ref<int, sycl::memory_order::relaxed, sycl::memory_scope::device,
+                   sycl::access::address_space::global_space> flag(usage[i]);
+  flag.store(1);
+}
+
+// element reference recording reads and writes
+//   - usage[0] is set on any read, usage[1] on any write
+//   - written[i] is set when element i is written
+template<typename Access_type, typename Usage_type>
+class tracked_reference{
+public:
+  using value_type = typename Access_type::value_type;
+
+  tracked_reference(const Access_type& data, const Usage_type& usage,
+                    const Usage_type& written, size_t i)
+    : data{data}, usage{usage}, written{written}, i{i}{}
+
+  operator value_type() const{
+    set_flag(usage, 0);
+    return data[i];
+  }
+
+  const tracked_reference& operator=(value_type value) const{
+    set_flag(usage, 1);
+    set_flag(written, i);
+    data[i] = value;
+    return *this;
+  }
+
+  const tracked_reference& operator=(const tracked_reference& other) const{
+    return *this = static_cast<value_type>(other);
+  }
+
+  const tracked_reference& operator+=(value_type value) const{
+    return *this = static_cast<value_type>(*this) + value;
+  }
+
+  const tracked_reference& operator*=(value_type value) const{
+    return *this = static_cast<value_type>(*this) * value;
+  }
+
+private:
+  Access_type data;
+  Usage_type usage;
+  Usage_type written;
+  size_t i;
+};
+
+// accessor wrapper handing out tracked references
+template<typename Access_type, typename Usage_type>
+class tracked_accessor{
+public:
+  tracked_accessor(Access_type data, Usage_type usage, Usage_type written)
+    : data{data}, usage{usage}, written{written}{}
+
+  tracked_reference<Access_type, Usage_type> operator[](size_t i) const{
+    return {data, usage, written, i};
+  }
+
+private:
+  Access_type data;
+  Usage_type usage;
+  Usage_type written;
+};
+
+// records accessor usage per kernel submission and reports access modes
+// that are broader than what the kernel actually did
+class access_linter{
+public:
+  // tracks a buffer in a command group, the tags are the accessor tags
+  template<typename Scalar_type, typename... Tag_types>
+  auto track(sycl::buffer<Scalar_type, 1>& buffer, sycl::handler& h,
+             const std::string& name, Tag_types... tags){
+    const size_t n = buffer.get_range()[0];
+
+    constexpr bool read  = (std::is_same_v<Tag_types, sycl::mode_tag_t<sycl::access_mode::read>> || ...);
+    constexpr bool write = (std::is_same_v<Tag_types, sycl::mode_tag_t<sycl::access_mode::write>> || ...);
+    constexpr bool no_init = (std::is_same_v<Tag_types, sycl::property::no_init> || ...);
+
+    // flag buffers start cleared, the iterator constructor copies the zeros
+    std::vector<int> zeros(std::max<size_t>(n, 2), 0);
+
+    record r{name, read ? "read_only" : (write ? "write_only" : "read_write"),
+             !read && !write, write || (!read && !write), no_init,
+             n, n*sizeof(Scalar_type),
+             sycl::buffer<int, 1>{zeros.begin(), zeros.begin() + 2},
+             sycl::buffer<int, 1>{zeros.begin(), zeros.begin() + n}};
+
+    sycl::accessor data{buffer, h, tags...};
+    sycl::accessor usage{r.usage, h, sycl::read_write};
+    sycl::accessor written{r.written, h, sycl::read_write};
+
+    pending.push_back(r);
+
+    return tracked_accessor<decltype(data), decltype(usage)>{data, usage, written};
+  }
+
+  // checks the accessors of the last submission and prints the findings
+  void report(const std::string& kernel_name){
+    for(auto& r : pending){
+      sycl::host_accessor usage{r.usage, sycl::read_only};
+      sycl::host_accessor written{r.written, sycl::read_only};
+
+      size_t written_count = 0;
+      for(size_t i = 0; i < r.count; ++i){
+        written_count += written[i];
+      }
+
+      const bool was_read = usage[0];
+      const bool was_written = usage[1];
+      const bool overwritten = written_count == r.count;
+
+      std::string suggestion;
+      size_t saved = 0;
+
+      if(!was_read && !was_written){
+        suggestion = "unused, remove the accessor";
+        saved = r.bytes;
+      }
+      else if(r.read_write && !was_written){
+        suggestion = "read_only";
+        saved = r.bytes;
+      }
+      else if(r.writable && !r.no_init && !was_read && overwritten){
+        suggestion = "write_only, no_init";
+        saved = r.bytes;
+      }
+
+      if(saved > 0){
+        std::cout << "[" << kernel_name << "] " << r.name << ": declared " << r.declared
+                  << (r.no_init ? ", no_init" : "") << " -> use " << suggestion
+                  << " (saves ~" << saved << " bytes)" << std::endl;
+        bytes_saved += saved;
+      }
+    }
+
+    pending.clear();
+  }
+
+  // total estimate over all reported submissions
+  void summary() const{
+    std::cout << "Estimated transfer savings: " << bytes_saved << " bytes" << std::endl;
+  }
+
+private:
+  struct record{
+    std::string name;
+    std::string declared;
+    bool read_write;
+    bool writable;
+    bool no_init;
+    size_t count;
+    size_t bytes;
+    sycl::buffer<int, 1> usage;
+    sycl::buffer<int, 1> written;
+  };
+
+  std::vector<record> pending;
+  size_t bytes_saved = 0;
+};
+
+// first example instrumented with the linter
+template<typename Queue_type>
+void linted_first_example(Queue_type Q){
+  access_linter linter;
+
+  // creating buffers
+  sycl::buffer<double> input_1{sycl::range{SIZE}};
+  sycl::buffer<double> input_2{sycl::range{SIZE}};
+  sycl::buffer<double> output{sycl::range{SIZE}};
+
+  // initializing
+  Q.submit([&](sycl::handler& h){
+    auto access_input_1 = linter.track(input_1, h, "input_1");
+    auto access_input_2 = linter.track(input_2, h, "input_2");
+    auto access_output  = linter.track(output, h, "output");
+
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      access_input_1[i] = 5.5;
+      access_input_2[i] = 8.4;
+      access_output[i]  = 0.0;
+    });
+  });
+  linter.report("initializing");
+
+  // vector addition
+  Q.submit([&](sycl::handler& h){
+    auto access_input_1 = linter.track(input_1, h, "input_1");
+    auto access_input_2 = linter.track(input_2, h, "input_2");
+    auto access_output  = linter.track(output, h, "output");
+
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      access_output[i] = access_input_1[i] + access_input_2[i];
+    });
+  });
+  linter.report("vector addition");
+
+  sycl::host_accessor host_output{output};
+
+  for(int i = 0; i < SIZE; ++i){
+    assert(fabs(host_output[i] - 13.9) < tol);
+  }
+
+  linter.summary();
+  std::cout << "The linted vector addition results are correct!" << std::endl;
+}
+
+int main(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  linted_first_example(Q);
+
+  return 0;
+}
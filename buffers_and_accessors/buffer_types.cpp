@@ -1,4 +1,93 @@
 #include <CL/sycl.hpp>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// splits a 2D buffer into row block sub-buffers
+//   - full rows keep every sub-buffer contiguous
+//   - block offsets are multiples of the device base address alignment
+//   - the last partition takes the remaining rows
+template<typename Scalar_type>
+std::vector<sycl::buffer<Scalar_type, 2>> partition_rows(sycl::buffer<Scalar_type, 2>& A,
+                                                        size_t partitions,
+                                                        const sycl::device& D){
+  assert(partitions > 0);
+
+  const size_t rows = A.get_range()[0];
+  const size_t cols = A.get_range()[1];
+
+  // the alignment is reported in bits
+  const size_t align_bytes = std::max<size_t>(D.get_info<sycl::info::device::mem_base_addr_align>()/8, 1);
+  const size_t row_bytes = cols*sizeof(Scalar_type);
+  const size_t align_rows = std::lcm(row_bytes, align_bytes)/row_bytes;
+
+  size_t block_rows = (rows + partitions - 1)/partitions;
+  block_rows = ((block_rows + align_rows - 1)/align_rows)*align_rows;
+
+  std::vector<sycl::buffer<Scalar_type, 2>> parts;
+  for(size_t r = 0; r < rows; r += block_rows){
+    parts.emplace_back(A, sycl::id<2>{r, 0}, sycl::range<2>{std::min(block_rows, rows - r), cols});
+  }
+
+  return parts;
+}
+
+// independent kernel chains on each partition, only the accessors of the
+// same partition depend on each other so the chains can run concurrently
+void partitioned_buffer_pipeline(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  constexpr size_t M = 1024;
+  constexpr size_t N = 64;
+  constexpr size_t partitions = 4;
+
+  sycl::buffer<double, 2> A{sycl::range{M, N}};
+  auto parts = partition_rows(A, partitions, Q.get_device());
+
+  for(size_t p = 0; p < parts.size(); ++p){
+    Q.submit([&](sycl::handler& h){
+      sycl::accessor A_access{parts[p], h, sycl::write_only, sycl::no_init};
+      h.parallel_for(parts[p].get_range(), [=](sycl::id<2> idx){
+        A_access[idx] = p + 1.0;
+      });
+    });
+
+    Q.submit([&](sycl::handler& h){
+      sycl::accessor A_access{parts[p], h, sycl::read_write};
+      h.parallel_for(parts[p].get_range(), [=](sycl::id<2> idx){
+        A_access[idx] *= 2.0;
+      });
+    });
+  }
+
+  // the whole buffer host accessor waits for every partition
+  sycl::host_accessor A_host{A, sycl::read_only};
+
+  size_t row = 0;
+  for(size_t p = 0; p < parts.size(); ++p){
+    for(size_t i = 0; i < parts[p].get_range()[0]; ++i, ++row){
+      for(size_t j = 0; j < N; ++j){
+        assert(A_host[row][j] == 2.0*(p + 1.0));
+      }
+    }
+  }
+
+  std::cout << "The partitioned buffer results are correct!" << std::endl;
+}
 
 int main(){
   const int M = 16;
@@ -35,5 +124,8 @@ int main(){
   sycl::buffer I1{I, sycl::id{0, 0}, sycl::range{1, M}};
   sycl::buffer I2{I, sycl::id{1, 0}, sycl::range{1, M}};
 
+  // row block sub-buffers used by concurrent kernels
+  partitioned_buffer_pipeline();
+
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,186 @@
+#pragma once
+
+// bounds checked indexing inside kernels
+//   - a checked_view wraps an accessor, or a usm pointer with its row major
+//     extent
+//   - without NDEBUG every index through a checked_view is compared with the
+//     extent, an out of range access is counted in a device side record, its
+//     write is dropped and its read returns 0 so the kernel keeps running
+//   - with NDEBUG bounds_log holds nothing and a checked_view indexes the
+//     accessor or pointer directly
+#include <CL/sycl.hpp>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#ifndef NDEBUG
+
+// device side record of out of range accesses
+//   - [0] number of out of range accesses
+//   - [1] first out of range index, [2] its dimension, [3] the extent
+class bounds_log{
+public:
+  using record_type = sycl::accessor<unsigned long long, 1, sycl::access_mode::read_write>;
+
+  bounds_log(){
+    reset();
+  }
+
+  record_type device_record(sycl::handler& h){
+    return record_type{record, h};
+  }
+
+  // prints the accesses recorded since the last report and returns their number
+  unsigned long long report(const std::string& kernel){
+    unsigned long long count = 0;
+    {
+      sycl::host_accessor r{record, sycl::read_only};
+      count = r[0];
+
+      if(count > 0){
+        std::cout << kernel << ": " << count << " out of range accesses, first index "
+                  << r[1] << " in dimension " << r[2] << " of extent " << r[3] << std::endl;
+      }
+    }
+
+    if(count > 0) reset();
+    return count;
+  }
+
+private:
+  void reset(){
+    sycl::host_accessor r{record, sycl::write_only, sycl::no_init};
+    for(int n = 0; n < 4; ++n){
+      r[n] = 0;
+    }
+  }
+
+  sycl::buffer<unsigned long long, 1> record{sycl::range<1>{4}};
+};
+
+// reference to an element that may be out of range, writes through a null
+// element are dropped and reads return 0
+template<typename Reference_type>
+class checked_reference{
+public:
+  using value_type = std::remove_cv_t<std::remove_reference_t<Reference_type>>;
+
+  explicit checked_reference(std::remove_reference_t<Reference_type>* element) : element{element}{}
+
+  operator value_type() const{
+    return element ? *element : value_type{};
+  }
+
+  const checked_reference& operator=(const value_type& value) const{
+    if(element) *element = value;
+    return *this;
+  }
+
+  const checked_reference& operator=(const checked_reference& other) const{
+    return *this = static_cast<value_type>(other);
+  }
+
+private:
+  std::remove_reference_t<Reference_type>* element;
+};
+
+#else
+
+class bounds_log{
+public:
+  struct record_type{};
+
+  record_type device_record(sycl::handler&){
+    return {};
+  }
+
+  unsigned long long report(const std::string&){
+    return 0;
+  }
+};
+
+#endif
+
+// row major usm allocation indexed like an accessor
+template<typename Scalar_type, int dims>
+class usm_extent{
+public:
+  usm_extent(Scalar_type* ptr, sycl::range<dims> extent) : ptr{ptr}, extent{extent}{}
+
+  sycl::range<dims> get_range() const{
+    return extent;
+  }
+
+  Scalar_type& operator[](sycl::id<dims> idx) const{
+    size_t linear = 0;
+    for(int d = 0; d < dims; ++d){
+      linear = linear*extent[d] + idx[d];
+    }
+    return ptr[linear];
+  }
+
+private:
+  Scalar_type* ptr;
+  sycl::range<dims> extent;
+};
+
+// view of an accessor or usm pointer indexed as view(i, j, ...)
+template<typename Accessor_type>
+class checked_view{
+public:
+  checked_view(Accessor_type access, bounds_log::record_type record)
+#ifndef NDEBUG
+    : access{access}, record{record}{}
+#else
+    : access{access}{}
+#endif
+
+  template<typename Scalar_type, int dims>
+  checked_view(Scalar_type* ptr, sycl::range<dims> extent, bounds_log::record_type record)
+    : checked_view{Accessor_type{ptr, extent}, record}{}
+
+  template<typename... Index_types>
+  decltype(auto) operator()(Index_types... index) const{
+    constexpr int dims = sizeof...(Index_types);
+    sycl::id<dims> idx{static_cast<size_t>(index)...};
+
+#ifndef NDEBUG
+    using reference_type = decltype(access[idx]);
+
+    const auto extent = access.get_range();
+    for(int d = 0; d < dims; ++d){
+      if(idx[d] >= extent[d]){
+        out_of_range(idx[d], d, extent[d]);
+        return checked_reference<reference_type>{nullptr};
+      }
+    }
+
+    return checked_reference<reference_type>{&access[idx]};
+#else
+    return access[idx];
+#endif
+  }
+
+private:
+#ifndef NDEBUG
+  void out_of_range(size_t index, int dim, size_t extent) const{
+    sycl::atomic_ref<unsigned long long, sycl::memory_order::relaxed, sycl::memory_scope::device,
+                     sycl::access::address_space::global_space> count{record[0]};
+
+    if(count.fetch_add(1ull) == 0){
+      record[1] = index;
+      record[2] = dim;
+      record[3] = extent;
+    }
+  }
+#endif
+
+  Accessor_type access;
+#ifndef NDEBUG
+  bounds_log::record_type record;
+#endif
+};
+
+template<typename Scalar_type, int dims>
+checked_view(Scalar_type*, sycl::range<dims>, bounds_log::record_type)
+  -> checked_view<usm_extent<Scalar_type, dims>>;
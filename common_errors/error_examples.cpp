@@ -1,5 +1,18 @@
+#include <cassert>
 #include <CL/sycl.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "checked_view.hpp"
 
 // prints device name
 template<typename Queue_type>
@@ -11,6 +24,241 @@ void print_device(Queue_type& Q){
             << "\n" << std::endl;
 }
 
+// asynchronous error with the commands it was raised for
+struct async_error{
+  std::chrono::system_clock::time_point time;
+  std::string queue;
+  std::string kernels;
+  std::string what;
+  int code;
+  bool recoverable;
+};
+
+// thread safe log of asynchronous errors
+class async_error_log{
+public:
+  void add(async_error error){
+    std::lock_guard<std::mutex> guard{mtx};
+    entries.push_back(std::move(error));
+  }
+
+  void print(){
+    std::lock_guard<std::mutex> guard{mtx};
+    for(auto& e : entries){
+      const auto t  = std::chrono::system_clock::to_time_t(e.time);
+      const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        e.time.time_since_epoch()).count()%1000;
+
+      std::cout << std::put_time(std::localtime(&t), "%F %T") << "."
+                << std::setfill('0') << std::setw(3) << ms << std::setfill(' ')
+                << " [" << e.queue << "] " << e.kernels << ": " << e.what
+                << " (code " << e.code << (e.recoverable ? ", recoverable)" : ")") << std::endl;
+    }
+  }
+
+private:
+  std::mutex mtx;
+  std::vector<async_error> entries;
+};
+
+async_error_log error_log;
+
+// failures another device may not have, as opposed to programming errors
+bool is_recoverable(const sycl::exception& e){
+  const auto code = e.code();
+  return code == sycl::errc::memory_allocation
+      || code == sycl::errc::platform
+      || code == sycl::errc::feature_not_supported
+      || code == sycl::errc::kernel_not_supported;
+}
+
+// queue whose asynchronous errors are logged instead of terminating
+//   - commands are submitted under a name, an error is logged with the
+//     names submitted since the last successful wait
+//   - exceptions are delivered by wait or by poll, which may run on another
+//     thread
+//   - the handler also records that a command of this queue failed, so a
+//     caller checks its own queue rather than the shared log
+class guarded_queue{
+public:
+  guarded_queue(const std::string& label, const sycl::device& D)
+    : label{label}, state{std::make_shared<pending_state>()},
+      Q{D, make_handler(label, state)}{}
+
+  template<typename CGF_type>
+  sycl::event submit(const std::string& kernel, CGF_type cgf){
+    state->add(kernel);
+    return Q.submit(cgf);
+  }
+
+  // waits and reports asynchronous errors to the log
+  void wait(){
+    std::lock_guard<std::mutex> guard{state->delivery};
+    Q.wait_and_throw();
+    state->take();
+  }
+
+  // reports asynchronous errors without waiting, a queue that is being
+  // waited on is skipped since its wait delivers the errors
+  void poll(){
+    std::unique_lock<std::mutex> guard{state->delivery, std::try_to_lock};
+    if(!guard.owns_lock()) return;
+    Q.throw_asynchronous();
+  }
+
+  sycl::queue& queue(){
+    return Q;
+  }
+
+  const std::string& name() const{
+    return label;
+  }
+
+  // failure recorded since the last reset, by the handler or the caller
+  void reset_failure(){
+    state->reset();
+  }
+
+  void record_failure(bool recoverable){
+    state->fail(recoverable);
+  }
+
+  bool failed(){
+    return state->failure().first;
+  }
+
+  // whether every failure since the last reset was recoverable
+  bool failure_recoverable(){
+    return state->failure().second;
+  }
+
+private:
+  // names submitted since the last successful wait and the failure of
+  // this queue, delivery serializes the handler so a wait returns after
+  // errors taken by a poll are logged
+  struct pending_state{
+    std::mutex delivery;
+    std::mutex mtx;
+    std::string kernels;
+    bool failed = false;
+    bool recoverable = true;
+
+    void add(const std::string& kernel){
+      std::lock_guard<std::mutex> guard{mtx};
+      kernels += (kernels.empty() ? "" : ",") + kernel;
+    }
+
+    std::string take(){
+      std::lock_guard<std::mutex> guard{mtx};
+      return std::exchange(kernels, {});
+    }
+
+    void fail(bool is_recoverable){
+      std::lock_guard<std::mutex> guard{mtx};
+      failed = true;
+      recoverable = recoverable && is_recoverable;
+    }
+
+    void reset(){
+      std::lock_guard<std::mutex> guard{mtx};
+      failed = false;
+      recoverable = true;
+    }
+
+    std::pair<bool, bool> failure(){
+      std::lock_guard<std::mutex> guard{mtx};
+      return {failed, recoverable};
+    }
+  };
+
+  static sycl::async_handler make_handler(const std::string& label,
+                                          std::shared_ptr<pending_state> state){
+    return [label, state](sycl::exception_list e_list){
+      const std::string kernels = state->take();
+      const auto now = std::chrono::system_clock::now();
+
+      for(auto &e : e_list){
+        try{
+          std::rethrow_exception(e);
+        } catch(sycl::exception& e){
+          error_log.add({now, label, kernels, e.what(), e.code().value(), is_recoverable(e)});
+          state->fail(is_recoverable(e));
+        } catch(std::exception& e){
+          error_log.add({now, label, kernels, e.what(), -1, false});
+          state->fail(false);
+        }
+      }
+    };
+  }
+
+  std::string label;
+  std::shared_ptr<pending_state> state;
+  sycl::queue Q;
+};
+
+// background thread calling throw_asynchronous on a set of queues
+class async_error_poller{
+public:
+  async_error_poller(std::vector<guarded_queue*> queues, std::chrono::milliseconds interval)
+    : worker{[this, queues, interval](){
+        std::unique_lock<std::mutex> lock{mtx};
+        while(!cv.wait_for(lock, interval, [this](){ return stopping; })){
+          lock.unlock();
+          for(auto* Q : queues){
+            Q->poll();
+          }
+          lock.lock();
+        }
+      }}{}
+
+  ~async_error_poller(){
+    {
+      std::lock_guard<std::mutex> guard{mtx};
+      stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+  }
+
+  async_error_poller(const async_error_poller&) = delete;
+  async_error_poller& operator=(const async_error_poller&) = delete;
+
+private:
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool stopping = false;
+  std::thread worker;
+};
+
+// runs a command group on the primary queue and, after a recoverable
+// failure, once more on the secondary queue, the command group must only
+// use buffers so its data can move between devices
+//   - a failure is read from the queue the command ran on, errors another
+//     queue reports meanwhile do not trigger a retry
+template<typename CGF_type>
+bool run_with_retry(guarded_queue& primary, guarded_queue& secondary,
+                    const std::string& kernel, CGF_type cgf){
+  for(auto* Q : {&primary, &secondary}){
+    Q->reset_failure();
+
+    try{
+      Q->submit(kernel, cgf);
+      Q->wait();
+    } catch(sycl::exception& e){
+      error_log.add({std::chrono::system_clock::now(), Q->name(), kernel, e.what(),
+                     e.code().value(), is_recoverable(e)});
+      Q->record_failure(is_recoverable(e));
+    }
+
+    if(!Q->failed()) return true;
+    if(!Q->failure_recoverable()) return false;
+
+    std::cout << kernel << " failed on " << Q->name() << std::endl;
+  }
+
+  return false;
+}
+
 // task graph executes asynchronously from host program
 template<typename Queue_type, typename Int_type>
 void asynchronous_task_graph(Queue_type Q, Int_type SIZE){
@@ -44,6 +292,30 @@ void larger_sub_buffer(Queue_type Q, Int_type SIZE){
   std::cout << "The sub buffer worked!" << std::endl;
 }
 
+// out of range kernel reads recorded by a checked view in debug builds,
+// unlike the larger sub buffer nothing is thrown and the kernel completes
+template<typename Queue_type, typename Int_type>
+void out_of_range_kernel(Queue_type Q, Int_type SIZE){
+  sycl::buffer<double> in_buf{sycl::range{SIZE}};
+  sycl::buffer<double> out_buf{sycl::range{SIZE}};
+  bounds_log bounds;
+
+  Q.submit([&](sycl::handler& h){
+    auto record = bounds.device_record(h);
+    checked_view in{sycl::accessor{in_buf, h, sycl::read_only}, record};
+    checked_view out{sycl::accessor{out_buf, h, sycl::write_only, sycl::no_init}, record};
+
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      // the last work item reads one past the end
+      out(idx[0]) = in(idx[0]) + in(idx[0] + 1);
+    });
+  });
+
+  Q.wait();
+
+  std::cout << bounds.report("out_of_range_kernel") << " out of range accesses" << std::endl;
+}
+
 // asynchronous error from empty command group
 void empty_command_group(){
   auto asynchronous_error_handler = [](sycl::exception_list e_list){
@@ -55,8 +327,6 @@ void empty_command_group(){
         std::cout << e.what() << std::endl;
       }
     }
-
-    std::terminate();
   };
 
   sycl::queue Q1{sycl::gpu_selector_v, asynchronous_error_handler};
@@ -117,6 +387,53 @@ auto catching_general_exception(Int_type SIZE){
   return 0;
 }
 
+// a failing command is retried on a secondary device while a background
+// thread reports asynchronous errors
+template<typename Int_type>
+void resilient_execution(Int_type SIZE){
+  guarded_queue primary{"gpu", sycl::device{sycl::gpu_selector_v}};
+  guarded_queue secondary{"cpu", sycl::device{sycl::cpu_selector_v}};
+
+  print_device(primary.queue());
+  print_device(secondary.queue());
+
+  async_error_poller poller{{&primary, &secondary}, std::chrono::milliseconds{10}};
+
+  sycl::buffer<double> buf{sycl::range{SIZE}};
+
+  // succeeds on the primary device
+  const bool filled = run_with_retry(primary, secondary, "fill", [&](sycl::handler& h){
+    sycl::accessor acc{buf, h, sycl::write_only, sycl::no_init};
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      acc[idx] = idx[0];
+    });
+  });
+
+  // fails on the first attempt to simulate a lost device
+  int attempts = 0;
+  const bool scaled = run_with_retry(primary, secondary, "scale", [&](sycl::handler& h){
+    sycl::accessor acc{buf, h, sycl::read_write};
+    const bool fail = attempts++ == 0;
+    h.host_task([=](){
+      if(fail){
+        throw sycl::exception(sycl::make_error_code(sycl::errc::platform), "injected device failure");
+      }
+      for(size_t i = 0; i < SIZE; ++i){
+        acc[i] *= 2.0;
+      }
+    });
+  });
+
+  sycl::host_accessor host_acc{buf, sycl::read_only};
+  for(size_t i = 0; i < SIZE; ++i){
+    assert(host_acc[i] == 2.0*i);
+  }
+
+  std::cout << "fill " << (filled ? "succeeded" : "failed") << ", scale "
+            << (scaled ? "succeeded" : "failed") << " after " << attempts << " attempts\n"
+            << "Asynchronous error log:" << std::endl;
+  error_log.print();
+}
 
 int main(){
   // establishing gpu for device queue
@@ -129,10 +446,12 @@ int main(){
   // testing error examples
   // asynchronous_task_graph(Q, SIZE);
   // larger_sub_buffer(Q, SIZE);
+  // out_of_range_kernel(Q, SIZE);
   // empty_command_group();
   // throw_random_error();
   // std_terminate();
   // catching_sycl_exception(SIZE);
   catching_general_exception(SIZE);
+  resilient_execution(SIZE);
   return 0;
 }
\ No newline at end of file
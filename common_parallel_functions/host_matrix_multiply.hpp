@@ -0,0 +1,94 @@
+#pragma once
+
+// host reference for the matrix multiply examples, C = A*B with A
+// rows x inner, B inner x cols and every matrix stored row major
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+// host reference matrix multiply C = A*B with A rows x inner, B inner x cols
+//   - row blocks are split over the hardware threads
+//   - loops are blocked for cache reuse of the A, B and C blocks
+//   - the innermost loop runs over contiguous rows of B and C so it vectorizes
+template<typename Scalar_type>
+void host_matrix_multiply(const Scalar_type* A, const Scalar_type* B, Scalar_type* C,
+                          size_t rows, size_t cols, size_t inner){
+  constexpr size_t block = 64;
+  const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+  auto worker = [=](size_t t){
+    for(size_t ib = t*block; ib < rows; ib += threads*block){
+      const size_t i_end = std::min(ib + block, rows);
+
+      std::fill(C + ib*cols, C + i_end*cols, Scalar_type{0});
+
+      for(size_t kb = 0; kb < inner; kb += block){
+        const size_t k_end = std::min(kb + block, inner);
+
+        for(size_t jb = 0; jb < cols; jb += block){
+          const size_t j_end = std::min(jb + block, cols);
+
+          for(size_t i = ib; i < i_end; ++i){
+            for(size_t k = kb; k < k_end; ++k){
+              const Scalar_type a_ik = A[i*inner + k];
+              const Scalar_type* B_row = B + k*cols;
+              Scalar_type* C_row = C + i*cols;
+
+              for(size_t j = jb; j < j_end; ++j){
+                C_row[j] += a_ik*B_row[j];
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for(size_t t = 1; t < threads; ++t){
+    pool.emplace_back(worker, t);
+  }
+  worker(0);
+
+  for(auto& thread : pool){
+    thread.join();
+  }
+}
+
+// checks a random sample of entries of C = A*B
+//   - each sampled entry must be within tol or the rounding error bound
+//     inner*eps*sum|a_ik*b_kj| of its dot product
+//   - with no failures in s samples the fraction of wrong entries is
+//     below 3/s at 95% confidence (rule of three)
+template<typename Scalar_type>
+void sample_check_matrix_multiply(const Scalar_type* A, const Scalar_type* B, const Scalar_type* C,
+                                  size_t rows, size_t cols, size_t inner,
+                                  size_t samples, Scalar_type tol){
+  std::default_random_engine generate(97);
+  std::uniform_int_distribution<size_t> row_distribution(0, rows - 1);
+  std::uniform_int_distribution<size_t> col_distribution(0, cols - 1);
+
+  const Scalar_type eps = std::numeric_limits<Scalar_type>::epsilon();
+
+  for(size_t s = 0; s < samples; ++s){
+    const size_t i = row_distribution(generate);
+    const size_t j = col_distribution(generate);
+
+    Scalar_type c_ij = 0;
+    Scalar_type magnitude = 0;
+    for(size_t k = 0; k < inner; ++k){
+      c_ij += A[i*inner + k]*B[k*cols + j];
+      magnitude += std::fabs(A[i*inner + k]*B[k*cols + j]);
+    }
+
+    assert(std::fabs(C[i*cols + j] - c_ij) <= std::max(tol, inner*eps*magnitude));
+  }
+
+  std::cout << "Sampled " << samples << " entries, error rate below "
+            << 300.0/samples << "% at 95% confidence" << std::endl;
+}
@@ -1,9 +1,21 @@
+// ahead of time compilation for the cpu target removes the jit step:
+//   icpx -fsycl -fsycl-targets=spir64_x86_64 matrix_multiply.cpp
+// with several targets the runtime picks the image matching the device:
+//   icpx -fsycl -fsycl-targets=spir64_x86_64,spir64 matrix_multiply.cpp
+
 #include <CL/sycl.hpp>
 #include <array>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <assert.h>
 #include <random>
 #include <algorithm>
+#include <vector>
+
+#include "host_matrix_multiply.hpp"
+#include "../common_errors/checked_view.hpp"
+#include "../work_item_comms/launch_config.hpp"
 
 // prints device name
 template<typename Queue_type>
@@ -15,11 +27,46 @@ void print_device(Queue_type& Q){
             << "\n" << std::endl;
 }
 
+// executable kernels of the program for one device
+using kernel_bundle_type = sycl::kernel_bundle<sycl::bundle_state::executable>;
+
+// builds every kernel of the program for the queue device at startup, a
+// submission using the returned bundle does not pay for jit compilation,
+// ahead of time compiled images are already executable and are returned
+// without a build
+template<typename Queue_type>
+kernel_bundle_type warmup_kernels(Queue_type& Q){
+  using ns = std::chrono::nanoseconds;
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  auto bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(Q.get_context(),
+                                                                        {Q.get_device()});
+
+  auto interval = std::chrono::steady_clock::now() - start_time;
+
+  std::cout << "Kernel warmup: " << std::chrono::duration_cast<ns>(interval).count()
+            << " ns" << std::endl;
+
+  return bundle;
+}
+
 // parallel matrix multiplication
 template<typename Queue_type, typename Scalar_type>
 void parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, Scalar_type* B,
-                                    Scalar_type* C, size_t M, size_t N, size_t K){
+                                    Scalar_type* C, size_t M, size_t N, size_t K,
+                                    const kernel_bundle_type& bundle){
+  bounds_log bounds;
+
   Q.submit([&](sycl::handler &h){
+    h.use_kernel_bundle(bundle);
+
+    auto record = bounds.device_record(h);
+
+    checked_view A_view{A, sycl::range{M, N}, record};
+    checked_view B_view{B, sycl::range{N, K}, record};
+    checked_view C_view{C, sycl::range{M, K}, record};
+
     h.parallel_for(sycl::range{M, K}, [=](sycl::id<2> idx){
       int i = idx[0];
       int j = idx[1];
@@ -27,26 +74,39 @@ void parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, Scalar_type* B
       Scalar_type c_ij = 0.0;
 
       for(int p = 0; p < N; ++p){
-        c_ij += A[i*N + p]*B[p*K + j];
+        c_ij += A_view(i, p)*B_view(p, j);
       }
-      C[i*K + j] = c_ij;
+      C_view(i, j) = c_ij;
     });
   }).wait();
+
+  bounds.report("parallel_matrix_multiplication");
 }
 
+// kernel names of the variants launched with b x b work groups, needed for
+// their work group limits
+template<typename Scalar_type>
+class nd_range_multiply_kernel;
+
+template<typename Scalar_type>
+class hierarchical_multiply_kernel;
+
 // nd-range parallel matrix multiplication
 template<typename Queue_type, typename Scalar_type>
 void nd_range_parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, Scalar_type* B,
                                              Scalar_type* C, size_t M, size_t N, size_t K,
-                                             size_t b){
+                                             size_t b, const kernel_bundle_type& bundle){
   Q.submit([&](sycl::handler &h){
+    h.use_kernel_bundle(bundle);
+
     // global nd range problem size
     sycl::range global{M, K};
 
     // local workgroup size
     sycl::range local{b, b};
 
-    h.parallel_for(sycl::nd_range{global, local}, [=](sycl::nd_item<2> it){
+    h.parallel_for<nd_range_multiply_kernel<Scalar_type>>(sycl::nd_range{global, local},
+                                                          [=](sycl::nd_item<2> it){
       int i = it.get_global_id(0);
       int j = it.get_global_id(1);
 
@@ -64,15 +124,18 @@ void nd_range_parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, Scala
 template<typename Queue_type, typename Scalar_type>
 void hierarchical_parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, Scalar_type* B,
                                                  Scalar_type* C, size_t M, size_t N, size_t K,
-                                                 size_t b){
+                                                 size_t b, const kernel_bundle_type& bundle){
   Q.submit([&](sycl::handler &h){
+    h.use_kernel_bundle(bundle);
+
     // number of groups
     sycl::range num_groups{M/b, K/b};
 
     // group size
     sycl::range group_size{b, b};
 
-    h.parallel_for_work_group(num_groups, group_size, [=](sycl::group<2> grp){
+    h.parallel_for_work_group<hierarchical_multiply_kernel<Scalar_type>>(num_groups, group_size,
+                                                                         [=](sycl::group<2> grp){
       int ib = grp.get_group_id(0);
       int jb = grp.get_group_id(1);
 
@@ -96,8 +159,10 @@ void hierarchical_parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, S
 template<typename Queue_type, typename Scalar_type>
 void logical_hierarchical_parallel_matrix_multiplication(Queue_type Q, Scalar_type* A, Scalar_type* B,
                                                          Scalar_type* C, size_t M, size_t N, size_t K,
-                                                         size_t b){
+                                                         size_t b, const kernel_bundle_type& bundle){
   Q.submit([&](sycl::handler &h){
+    h.use_kernel_bundle(bundle);
+
     // number of groups
     sycl::range num_groups{M/b, K/b};
 
@@ -125,21 +190,36 @@ void logical_hierarchical_parallel_matrix_multiplication(Queue_type Q, Scalar_ty
 }
 
 int main(){
+  using ns = std::chrono::nanoseconds;
+
+  // persisting jit compiled kernels across runs, must be set before the
+  // runtime starts and does not override a value set by the user
+  setenv("SYCL_CACHE_PERSISTENT", "1", 0);
+
   // establishing gpu for device queue
   sycl::queue Q{sycl::gpu_selector_v};
   print_device(Q);
 
+  // building the kernels outside of the timed region
+  const auto bundle = warmup_kernels(Q);
+
   // matrix dimensional value
   constexpr size_t M = 256;
   constexpr size_t N = 1024;
   constexpr size_t K = 512;
 
-  // local work group size
-  constexpr size_t b = 4;
+  // local work group size fitting both variants launched with b x b groups
+  const size_t limit = std::min(kernel_work_group_limit<nd_range_multiply_kernel<double>>(Q),
+                                kernel_work_group_limit<hierarchical_multiply_kernel<double>>(Q));
+  const size_t b = pick_square_local_size(Q, limit, M, K, 16);
 
   // tolerance
   const double tol = 1.0E-6;
 
+  // validation type, 0 checks every entry and 1 checks a random sample
+  constexpr int validation = 0;
+  constexpr size_t samples = 1024;
+
   // matrices on host memory
   std::vector<double> A_host(M*N);
   std::vector<double> B_host(N*K);
@@ -168,22 +248,34 @@ int main(){
   Q.memcpy(B_device, &B_host[0], N*K*sizeof(double));
   Q.memcpy(C_device, &C_host[0], M*K*sizeof(double));
 
-  //parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K);
-  //nd_range_parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, b);
-  //hierarchical_parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, b);
-  logical_hierarchical_parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, b);
+  // keeping the transfers out of the timed region
+  Q.wait();
+
+  //parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, bundle);
+  //nd_range_parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, b, bundle);
+  //hierarchical_parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, b, bundle);
+  auto start_time = std::chrono::steady_clock::now();
+  logical_hierarchical_parallel_matrix_multiplication(Q, A_device, B_device, C_device, M, N, K, b, bundle);
+  auto interval = std::chrono::steady_clock::now() - start_time;
+
+  std::cout << "First matrix multiplication: "
+            << std::chrono::duration_cast<ns>(interval).count() << " ns" << std::endl;
 
   // copying device to host memory
-  Q.memcpy(&C_host[0], C_device, M*K*sizeof(double));
+  Q.memcpy(&C_host[0], C_device, M*K*sizeof(double)).wait();
 
   // confirming results
-  for(int i = 0; i < M; ++i){
-    for(int j = 0; j < K; ++j){
-      double c_ij = 0.0;
-      for(int p = 0; p < N; ++p){
-        c_ij += A_host[i*N + p]*B_host[p*K + j];
+  if constexpr (validation == 1){
+    sample_check_matrix_multiply(A_host.data(), B_host.data(), C_host.data(), M, K, N, samples, tol);
+  }
+  else{
+    std::vector<double> C_reference(M*K);
+    host_matrix_multiply(A_host.data(), B_host.data(), C_reference.data(), M, K, N);
+
+    for(int i = 0; i < M; ++i){
+      for(int j = 0; j < K; ++j){
+        assert(std::fabs(C_host[i*K + j] - C_reference[i*K + j]) < tol);
       }
-      assert(std::fabs(C_host[i*K + j] - c_ij) < tol);
     }
   }
 
@@ -0,0 +1,361 @@
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../work_item_comms/launch_config.hpp"
+
+// number of timed runs per kernel, the fastest one is reported
+constexpr int repeats = 5;
+
+// values streamed by the bandwidth micro-kernel
+constexpr size_t stream_size = 1 << 24;
+
+// work items and dependent fma iterations of the compute micro-kernel
+constexpr size_t flop_items = 1 << 20;
+constexpr int flop_iterations = 1024;
+constexpr int flop_chains = 8;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// fastest device execution time in seconds of a submission, the queue must
+// have enable_profiling and the first run is a warm up
+template<typename Queue_type, typename Submit_type>
+double time_kernel(Queue_type& Q, Submit_type submit){
+  using namespace sycl::info;
+
+  submit(Q).wait();
+
+  double best = std::numeric_limits<double>::max();
+  for(int r = 0; r < repeats; ++r){
+    auto e = submit(Q);
+    e.wait();
+
+    const auto start = e.template get_profiling_info<event_profiling::command_start>();
+    const auto end   = e.template get_profiling_info<event_profiling::command_end>();
+    best = std::min(best, (end - start)*1.0E-9);
+  }
+  return best;
+}
+
+// measured machine ceilings
+struct machine_peaks{
+  double bandwidth; // bytes per second
+  double flops;     // flops per second
+
+  // arithmetic intensity where the kernels become compute bound
+  double ridge() const{
+    return flops/bandwidth;
+  }
+
+  double attainable(double intensity) const{
+    return std::min(flops, intensity*bandwidth);
+  }
+};
+
+// peak memory bandwidth from a stream triad, 3 values moved per item
+template<typename Queue_type, typename Scalar_type>
+double measure_bandwidth(Queue_type& Q){
+  Scalar_type *A = sycl::malloc_device<Scalar_type>(stream_size, Q);
+  Scalar_type *B = sycl::malloc_device<Scalar_type>(stream_size, Q);
+  Scalar_type *C = sycl::malloc_device<Scalar_type>(stream_size, Q);
+
+  Q.fill(B, Scalar_type(1), stream_size);
+  Q.fill(C, Scalar_type(2), stream_size);
+  Q.wait();
+
+  const double seconds = time_kernel(Q, [=](Queue_type& Q){
+    return Q.parallel_for(stream_size, [=](sycl::id<1> idx){
+      A[idx] = B[idx] + Scalar_type(3)*C[idx];
+    });
+  });
+
+  sycl::free(A, Q);
+  sycl::free(B, Q);
+  sycl::free(C, Q);
+
+  return 3.0*stream_size*sizeof(Scalar_type)/seconds;
+}
+
+// peak flop rate from independent fma chains kept in registers
+template<typename Queue_type, typename Scalar_type>
+double measure_flops(Queue_type& Q){
+  Scalar_type *out = sycl::malloc_device<Scalar_type>(flop_items, Q);
+
+  const double seconds = time_kernel(Q, [=](Queue_type& Q){
+    return Q.parallel_for(flop_items, [=](sycl::id<1> idx){
+      const Scalar_type x = Scalar_type(0.999999);
+      const Scalar_type y = Scalar_type(1.0E-7);
+
+      Scalar_type a[flop_chains];
+      for(int c = 0; c < flop_chains; ++c){
+        a[c] = Scalar_type(idx[0] + c)*Scalar_type(1.0E-9);
+      }
+
+      for(int it = 0; it < flop_iterations; ++it){
+        for(int c = 0; c < flop_chains; ++c){
+          a[c] = sycl::fma(a[c], x, y);
+        }
+      }
+
+      Scalar_type sum = 0;
+      for(int c = 0; c < flop_chains; ++c){
+        sum += a[c];
+      }
+      out[idx] = sum;
+    });
+  });
+
+  sycl::free(out, Q);
+
+  return 2.0*flop_items*flop_iterations*flop_chains/seconds;
+}
+
+// a benchmarked kernel annotated with its flops and compulsory memory traffic
+struct roofline_point{
+  std::string name;
+  double flops;
+  double bytes;
+  double seconds;
+
+  double intensity() const{
+    return flops/bytes;
+  }
+};
+
+// prints achieved against attainable performance for every kernel
+void print_roofline(const machine_peaks& peaks, const std::vector<roofline_point>& points){
+  std::cout << std::fixed << std::setprecision(2)
+            << "Peak bandwidth: " << peaks.bandwidth*1.0E-9 << " GB/s\n"
+            << "Peak compute:   " << peaks.flops*1.0E-9 << " GFLOP/s\n"
+            << "Ridge point:    " << peaks.ridge() << " flop/byte\n" << std::endl;
+
+  std::cout << std::left << std::setw(24) << "kernel" << std::right
+            << std::setw(12) << "flop/byte"
+            << std::setw(12) << "GB/s"
+            << std::setw(12) << "GFLOP/s"
+            << std::setw(14) << "attainable"
+            << std::setw(10) << "% roof"
+            << std::setw(10) << "bound" << std::endl;
+
+  for(auto& p : points){
+    const double achieved   = p.flops/p.seconds;
+    const double attainable = peaks.attainable(p.intensity());
+
+    std::cout << std::left << std::setw(24) << p.name << std::right
+              << std::setw(12) << p.intensity()
+              << std::setw(12) << p.bytes/p.seconds*1.0E-9
+              << std::setw(12) << achieved*1.0E-9
+              << std::setw(14) << attainable*1.0E-9
+              << std::setw(10) << 100.0*achieved/attainable
+              << std::setw(10) << (p.intensity() < peaks.ridge() ? "memory" : "compute")
+              << std::endl;
+  }
+}
+
+// vector addition, one flop per three values
+template<typename Queue_type, typename Scalar_type>
+roofline_point vector_addition_point(Queue_type& Q, size_t SIZE){
+  Scalar_type *A = sycl::malloc_device<Scalar_type>(SIZE, Q);
+  Scalar_type *B = sycl::malloc_device<Scalar_type>(SIZE, Q);
+  Scalar_type *C = sycl::malloc_device<Scalar_type>(SIZE, Q);
+
+  Q.fill(A, Scalar_type(8.39), SIZE);
+  Q.fill(B, Scalar_type(2.67), SIZE);
+  Q.wait();
+
+  const double seconds = time_kernel(Q, [=](Queue_type& Q){
+    return Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+      C[idx] = A[idx] + B[idx];
+    });
+  });
+
+  sycl::free(A, Q);
+  sycl::free(B, Q);
+  sycl::free(C, Q);
+
+  return {"vector addition", 1.0*SIZE, 3.0*SIZE*sizeof(Scalar_type), seconds};
+}
+
+// matrix addition, one flop per three values
+template<typename Queue_type, typename Scalar_type>
+roofline_point matrix_addition_point(Queue_type& Q, size_t M, size_t N){
+  Scalar_type *A = sycl::malloc_device<Scalar_type>(M*N, Q);
+  Scalar_type *B = sycl::malloc_device<Scalar_type>(M*N, Q);
+  Scalar_type *C = sycl::malloc_device<Scalar_type>(M*N, Q);
+
+  Q.fill(A, Scalar_type(8.39), M*N);
+  Q.fill(B, Scalar_type(2.67), M*N);
+  Q.wait();
+
+  const double seconds = time_kernel(Q, [=](Queue_type& Q){
+    return Q.parallel_for(sycl::range{M, N}, [=](sycl::id<2> idx){
+      const int i = idx[0];
+      const int j = idx[1];
+      C[i*N + j] = A[i*N + j] + B[i*N + j];
+    });
+  });
+
+  sycl::free(A, Q);
+  sycl::free(B, Q);
+  sycl::free(C, Q);
+
+  return {"matrix addition", 1.0*M*N, 3.0*M*N*sizeof(Scalar_type), seconds};
+}
+
+// matrix multiply kernel shapes benchmarked in the repo, C = A*B with A M x K
+// and B K x N, the intensity counts each matrix once so the gap to the roof
+// shows how much of the available reuse a variant actually gets
+//   - naive is parallel_matrix_multiplication, one work item per entry
+//   - nd_range is nd_range_parallel_matrix_multiplication, b x b work groups
+//     from pick_square_local_size, the hierarchical variants launch the same
+//   - tiled is ndrange_tiled_matrix_multiply of work_item_comms, 1 x tile
+//     work groups sharing a local tile of a row of A
+enum class gemm_variant{naive, nd_range, tiled};
+
+// kernel names of the work group variants, needed for their work group limits
+template<typename Scalar_type>
+class roofline_nd_range_kernel;
+
+template<typename Scalar_type>
+class roofline_tiled_kernel;
+
+template<typename Queue_type, typename Scalar_type>
+roofline_point matrix_multiply_point(Queue_type& Q, size_t M, size_t N, size_t K,
+                                     gemm_variant variant){
+  Scalar_type *A = sycl::malloc_device<Scalar_type>(M*K, Q);
+  Scalar_type *B = sycl::malloc_device<Scalar_type>(K*N, Q);
+  Scalar_type *C = sycl::malloc_device<Scalar_type>(M*N, Q);
+
+  Q.fill(A, Scalar_type(1.5), M*K);
+  Q.fill(B, Scalar_type(2.5), K*N);
+  Q.wait();
+
+  auto naive = [=](Queue_type& Q){
+    return Q.parallel_for(sycl::range{M, N}, [=](sycl::id<2> idx){
+      const int i = idx[0];
+      const int j = idx[1];
+
+      Scalar_type c_ij = 0;
+      for(int k = 0; k < K; ++k){
+        c_ij += A[i*K + k]*B[k*N + j];
+      }
+      C[i*N + j] = c_ij;
+    });
+  };
+
+  using nd_range_name = roofline_nd_range_kernel<Scalar_type>;
+
+  size_t b = 0;
+  if(variant == gemm_variant::nd_range){
+    b = pick_square_local_size(Q, kernel_work_group_limit<nd_range_name>(Q), M, N, 16);
+  }
+
+  auto nd_range = [=](Queue_type& Q){
+    return Q.template parallel_for<nd_range_name>(sycl::nd_range{sycl::range{M, N}, sycl::range{b, b}},
+                                                  [=](sycl::nd_item<2> it){
+      const int i = it.get_global_id(0);
+      const int j = it.get_global_id(1);
+
+      Scalar_type c_ij = 0;
+      for(int k = 0; k < K; ++k){
+        c_ij += A[i*K + k]*B[k*N + j];
+      }
+      C[i*N + j] = c_ij;
+    });
+  };
+
+  using tiled_name = roofline_tiled_kernel<Scalar_type>;
+
+  size_t tile = 0;
+  if(variant == gemm_variant::tiled){
+    const size_t limit = kernel_work_group_limit<tiled_name>(Q);
+    tile = pick_local_size(Q, limit, std::gcd(N, K), 32, sizeof(Scalar_type));
+    validate_launch(Q, limit, N, tile, tile*sizeof(Scalar_type));
+  }
+
+  auto tiled = [=](Queue_type& Q){
+    return Q.submit([&](sycl::handler& h){
+      auto tile_access = sycl::local_accessor<Scalar_type, 1>(tile, h);
+
+      h.parallel_for<tiled_name>(sycl::nd_range<2>{{M, N}, {1, tile}}, [=](sycl::nd_item<2> it){
+        const int i = it.get_global_id()[0];
+        const int j = it.get_global_id()[1];
+
+        const int x = it.get_local_id()[1];
+
+        Scalar_type c_ij = 0;
+        for(int kk = 0; kk < K; kk += tile){
+          tile_access[x] = A[i*K + kk + x];
+
+          sycl::group_barrier(it.get_group());
+
+          for(int k = 0; k < tile; ++k){
+            c_ij += tile_access[k]*B[(kk + k)*N + j];
+          }
+
+          sycl::group_barrier(it.get_group());
+        }
+        C[i*N + j] = c_ij;
+      });
+    });
+  };
+
+  double seconds = 0;
+  std::string name;
+  switch(variant){
+    case gemm_variant::naive:
+      seconds = time_kernel(Q, naive);
+      name = "naive matrix multiply";
+      break;
+    case gemm_variant::nd_range:
+      seconds = time_kernel(Q, nd_range);
+      name = "nd_range " + std::to_string(b) + "x" + std::to_string(b) + " multiply";
+      break;
+    case gemm_variant::tiled:
+      seconds = time_kernel(Q, tiled);
+      name = "tiled 1x" + std::to_string(tile) + " multiply";
+      break;
+  }
+
+  sycl::free(A, Q);
+  sycl::free(B, Q);
+  sycl::free(C, Q);
+
+  return {name, 2.0*M*N*K, 1.0*(M*K + K*N + M*N)*sizeof(Scalar_type), seconds};
+}
+
+int main(){
+  // establishing gpu for a profiling device queue
+  sycl::queue Q{sycl::gpu_selector_v, sycl::property::queue::enable_profiling()};
+  print_device(Q);
+
+  machine_peaks peaks{measure_bandwidth<sycl::queue, double>(Q),
+                      measure_flops<sycl::queue, double>(Q)};
+
+  // the additions use sizes chosen for the roofline, the 512 and 512 x 256
+  // of the examples would only measure the launch overhead, the multiplies
+  // use the shapes of the matrix multiply examples
+  std::vector<roofline_point> points;
+  points.push_back(vector_addition_point<sycl::queue, double>(Q, 1 << 24));
+  points.push_back(matrix_addition_point<sycl::queue, double>(Q, 4096, 4096));
+  points.push_back(matrix_multiply_point<sycl::queue, double>(Q, 256, 512, 1024, gemm_variant::naive));
+  points.push_back(matrix_multiply_point<sycl::queue, double>(Q, 256, 512, 1024, gemm_variant::nd_range));
+  points.push_back(matrix_multiply_point<sycl::queue, double>(Q, 256, 128, 512, gemm_variant::tiled));
+
+  print_roofline(peaks, points);
+
+  return 0;
+}
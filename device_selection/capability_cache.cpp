@@ -0,0 +1,270 @@
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "../work_item_comms/launch_config.hpp"
+
+namespace dinfo = sycl::info::device;
+
+// problem size of the tuned kernel
+constexpr size_t SIZE = 1 << 20;
+
+// prints device name
+template<typename Queue_type, typename String_type>
+void print_device(Queue_type& Q, String_type name){
+  std::cout << name << std::endl;
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// identity of the running binary from its size and modification time, a
+// rebuild invalidates the cache without reading the executable
+std::string binary_hash(){
+  struct stat info{};
+  if(stat("/proc/self/exe", &info) != 0) return "unknown";
+
+  std::ostringstream out;
+  out << std::hex << info.st_size << "-" << info.st_mtim.tv_sec << "." << info.st_mtim.tv_nsec;
+  return out.str();
+}
+
+// probed device properties and autotuned kernel parameters
+struct device_capabilities{
+  size_t max_work_group_size = 0;
+  size_t local_mem_size = 0;
+  std::vector<size_t> sub_group_sizes;
+  bool usm_shared = false;
+  bool usm_device = false;
+  std::map<std::string, long long> tuned;
+};
+
+// queries the device, the same properties as usm/querries.cpp and the
+// limits used to pick launch configurations
+device_capabilities probe_device(const sycl::device &D){
+  device_capabilities caps;
+  caps.max_work_group_size = D.get_info<dinfo::max_work_group_size>();
+  caps.local_mem_size      = D.get_info<dinfo::local_mem_size>();
+  caps.sub_group_sizes     = D.get_info<dinfo::sub_group_sizes>();
+  caps.usm_shared          = D.get_info<dinfo::usm_shared_allocations>();
+  caps.usm_device          = D.get_info<dinfo::usm_device_allocations>();
+  return caps;
+}
+
+// on disk cache of device capabilities and tuned parameters, in the tab
+// separated format of the performance cache of selectors.cpp
+//   - one line per device, keyed by device name, driver and binary hash
+//   - the key is followed by a tab and the space separated work group size,
+//     local memory size, usm support, sub-group sizes as a comma separated
+//     list and tuned parameters as a comma separated list of name=value,
+//     an empty list is written as -
+class capability_cache{
+public:
+  explicit capability_cache(const std::string &path) : path{path}, hash{binary_hash()}{
+    try{
+      load();
+    } catch(std::exception &e){
+      // a corrupt cache file is probed again and rewritten
+      std::cout << "Ignoring corrupt cache " << path << ": " << e.what() << std::endl;
+      entries.clear();
+      dirty = true;
+    }
+  }
+
+  ~capability_cache(){
+    if(dirty) save();
+  }
+
+  capability_cache(const capability_cache&) = delete;
+  capability_cache& operator=(const capability_cache&) = delete;
+
+  // cached capabilities of a device, probed on a miss
+  device_capabilities& get(const sycl::device &D){
+    const std::string k = key(D);
+    auto it = entries.find(k);
+
+    if(it == entries.end()){
+      it = entries.emplace(k, probe_device(D)).first;
+      dirty = true;
+      ++misses;
+    }
+
+    return it->second;
+  }
+
+  // tuned parameter of a device, or -1 when it was never tuned
+  long long tuned(const sycl::device &D, const std::string &name){
+    auto &t = get(D).tuned;
+    auto it = t.find(name);
+    return it == t.end() ? -1 : it->second;
+  }
+
+  void set_tuned(const sycl::device &D, const std::string &name, long long value){
+    get(D).tuned[name] = value;
+    dirty = true;
+  }
+
+  size_t probes() const{
+    return misses;
+  }
+
+  void save() const{
+    std::ofstream out{path};
+    for(auto &[k, caps] : entries){
+      out << k << '\t' << caps.max_work_group_size << ' ' << caps.local_mem_size << ' '
+          << caps.usm_shared << ' ' << caps.usm_device << ' ';
+
+      if(caps.sub_group_sizes.empty()) out << '-';
+      for(size_t s = 0; s < caps.sub_group_sizes.size(); ++s){
+        out << (s ? "," : "") << caps.sub_group_sizes[s];
+      }
+      out << ' ';
+
+      if(caps.tuned.empty()) out << '-';
+      for(auto it = caps.tuned.begin(); it != caps.tuned.end(); ++it){
+        out << (it == caps.tuned.begin() ? "" : ",") << it->first << '=' << it->second;
+      }
+      out << '\n';
+    }
+  }
+
+private:
+  // reads the lines of the cache file, throws on a malformed line
+  //   - lines written under another binary hash are dropped and the file is
+  //     rewritten without them
+  void load(){
+    std::ifstream in{path};
+    std::string k;
+    std::string fields;
+
+    while(std::getline(in, k, '\t') && std::getline(in, fields)){
+      device_capabilities caps;
+      std::string sub_groups;
+      std::string tuned;
+
+      std::istringstream line{fields};
+      if(!(line >> caps.max_work_group_size >> caps.local_mem_size >> caps.usm_shared
+                >> caps.usm_device >> sub_groups >> tuned)){
+        throw std::runtime_error("malformed entry " + k);
+      }
+
+      const bool current = k.size() > hash.size() &&
+                           k.compare(k.size() - hash.size() - 1, std::string::npos, "|" + hash) == 0;
+      if(!current){
+        dirty = true;
+        continue;
+      }
+
+      std::istringstream sizes{sub_groups == "-" ? "" : sub_groups};
+      for(std::string size; std::getline(sizes, size, ',');){
+        caps.sub_group_sizes.push_back(std::stoull(size));
+      }
+
+      std::istringstream parameters{tuned == "-" ? "" : tuned};
+      for(std::string parameter; std::getline(parameters, parameter, ',');){
+        const size_t split = parameter.find('=');
+        if(split == std::string::npos){
+          throw std::runtime_error("malformed tuned parameter " + parameter);
+        }
+        caps.tuned[parameter.substr(0, split)] = std::stoll(parameter.substr(split + 1));
+      }
+
+      entries[k] = caps;
+    }
+  }
+
+  std::string key(const sycl::device &D) const{
+    return D.get_info<dinfo::name>() + "|" + D.get_info<dinfo::driver_version>() + "|" + hash;
+  }
+
+  std::string path;
+  std::string hash;
+  std::map<std::string, device_capabilities> entries;
+  bool dirty = false;
+  size_t misses = 0;
+};
+
+// kernel name of the tuned kernel, needed for its work group limit
+class tuned_scaling_kernel;
+
+// picks the fastest work group size of a scaling kernel within the device
+// and kernel work group limits
+template<typename Queue_type>
+long long tune_local_size(Queue_type &Q, const device_capabilities &caps){
+  using ns = std::chrono::nanoseconds;
+
+  const size_t limit = std::min<size_t>({caps.max_work_group_size,
+                                         kernel_work_group_limit<tuned_scaling_kernel>(Q), 1024});
+
+  double *A = sycl::malloc_device<double>(SIZE, Q);
+  Q.fill(A, 1.0, SIZE).wait();
+
+  long long best = 1;
+  ns::rep best_time = std::numeric_limits<ns::rep>::max();
+
+  for(size_t local = 16; local <= limit; local *= 2){
+    auto run = [&](){
+      Q.template parallel_for<tuned_scaling_kernel>(sycl::nd_range<1>{sycl::range<1>{SIZE}, sycl::range<1>{local}}, [=](sycl::nd_item<1> it){
+        const size_t i = it.get_global_id(0);
+        A[i] = 2.0*A[i] + 1.0;
+      }).wait();
+    };
+
+    // warming up the kernel
+    run();
+
+    auto start_time = std::chrono::steady_clock::now();
+    run();
+    auto interval = std::chrono::steady_clock::now() - start_time;
+
+    const auto time = std::chrono::duration_cast<ns>(interval).count();
+    if(time < best_time){
+      best_time = time;
+      best = local;
+    }
+  }
+
+  sycl::free(A, Q);
+  return best;
+}
+
+int main(){
+  using ns = std::chrono::nanoseconds;
+
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q, "GPU Device Selector");
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  capability_cache cache{"device_capabilities.cache"};
+  auto &caps = cache.get(Q.get_device());
+
+  long long local_size = cache.tuned(Q.get_device(), "scale.local_size");
+  if(local_size < 0){
+    local_size = tune_local_size(Q, caps);
+    cache.set_tuned(Q.get_device(), "scale.local_size", local_size);
+  }
+
+  auto interval = std::chrono::steady_clock::now() - start_time;
+
+  std::cout << "Startup: " << std::chrono::duration_cast<ns>(interval).count() << " ns ("
+            << (cache.probes() ? "probed and tuned" : "from cache") << ")\n"
+            << "Max work group size: " << caps.max_work_group_size << "\n"
+            << "Local memory size:   " << caps.local_mem_size << "\n"
+            << "USM shared/device:   " << caps.usm_shared << "/" << caps.usm_device << "\n"
+            << "Tuned local size:    " << local_size << std::endl;
+
+  return 0;
+}
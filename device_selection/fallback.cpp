@@ -1,7 +1,13 @@
 #include <CL/sycl.hpp>
+#include <algorithm>
 #include <array>
 #include <assert.h>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "../work_item_comms/launch_config.hpp"
 
 // prints device name
 template<typename Queue_type, typename String_type>
@@ -14,10 +20,195 @@ void print_device(Queue_type& Q, String_type name){
             << "\n" << std::endl;
 }
 
+// kernel name of the fallback example, needed for its work group limit
+class fallback_kernel;
+
+// splits the rows of a 2D nd_range between two devices
+//   - the primary share of the rows follows the measured kernel throughput
+//     and is adapted after every iteration
+//   - a device that throws is dropped and its rows are rerun on the other,
+//     run throws std::runtime_error once both devices have failed
+class co_executor{
+public:
+  co_executor(const sycl::device& primary, const sycl::device& secondary){
+    // asynchronous errors are rethrown from wait_and_throw
+    auto rethrow = [](sycl::exception_list e_list){
+      for(auto& e : e_list){
+        std::rethrow_exception(e);
+      }
+    };
+
+    Q.emplace_back(primary, rethrow, sycl::property::queue::enable_profiling());
+    Q.emplace_back(secondary, rethrow, sycl::property::queue::enable_profiling());
+  }
+
+  ~co_executor(){
+    for(size_t d = 0; d < Q.size(); ++d){
+      if(out[d] != nullptr) sycl::free(out[d], Q[d]);
+    }
+  }
+
+  co_executor(const co_executor&) = delete;
+  co_executor& operator=(const co_executor&) = delete;
+
+  // share of the rows given to the primary device
+  double primary_share() const{
+    return share;
+  }
+
+  // computes host_out[i*cols + j] = kernel(i, j) over both devices with
+  // square work groups of at most preferred_local fitting the live devices
+  template<typename Kernel_name, typename Kernel_type>
+  void run(size_t rows, size_t cols, size_t preferred_local, double* host_out, Kernel_type kernel){
+    size_t local = preferred_local;
+    for(int d = 0; d < 2; ++d){
+      if(!alive[d]) continue;
+      local = std::min(local, pick_square_local_size(Q[d], kernel_work_group_limit<Kernel_name>(Q[d]),
+                                                     rows, cols, preferred_local));
+    }
+
+    const size_t blocks = rows/local;
+
+    size_t primary_blocks = std::lround(share*blocks);
+    if(!alive[0]) primary_blocks = 0;
+    if(!alive[1]) primary_blocks = blocks;
+
+    const size_t split = std::min(primary_blocks, blocks)*local;
+    const size_t begin[2] = {0, split};
+    const size_t end[2]   = {split, rows};
+
+    sycl::event computed[2];
+    sycl::event copied[2];
+    bool failed[2] = {false, false};
+
+    for(int d = 0; d < 2; ++d){
+      if(begin[d] == end[d]) continue;
+      try{
+        launch<Kernel_name>(d, begin[d], end[d], cols, local, host_out, kernel, computed[d], copied[d]);
+      } catch(sycl::exception& e){
+        failed[d] = true;
+      }
+    }
+
+    double time[2] = {0.0, 0.0};
+
+    for(int d = 0; d < 2; ++d){
+      if(begin[d] == end[d] || failed[d]) continue;
+      try{
+        copied[d].wait_and_throw();
+        time[d] = computed[d].get_profiling_info<sycl::info::event_profiling::command_end>() -
+                  computed[d].get_profiling_info<sycl::info::event_profiling::command_start>();
+      } catch(sycl::exception& e){
+        failed[d] = true;
+      }
+    }
+
+    // rerunning failed rows on the other device
+    for(int d = 0; d < 2; ++d){
+      if(!failed[d]) continue;
+
+      std::cout << "Device " << d << " failed, falling back" << std::endl;
+      alive[d] = false;
+
+      if(!alive[1 - d]){
+        throw std::runtime_error("Both co-execution devices failed");
+      }
+
+      try{
+        launch<Kernel_name>(1 - d, begin[d], end[d], cols, local, host_out, kernel, computed[d], copied[d]);
+        copied[d].wait_and_throw();
+      } catch(sycl::exception& e){
+        std::cout << "Device " << 1 - d << " failed in the fallback: " << e.what() << std::endl;
+        alive[1 - d] = false;
+        throw std::runtime_error("Both co-execution devices failed");
+      }
+    }
+
+    // moving the split towards equal finish times
+    if(alive[0] && alive[1] && time[0] > 0.0 && time[1] > 0.0){
+      const double rate_0 = (end[0] - begin[0])/time[0];
+      const double rate_1 = (end[1] - begin[1])/time[1];
+      share = 0.5*share + 0.5*rate_0/(rate_0 + rate_1);
+    }
+    else if(alive[0] && alive[1] && (begin[0] == end[0] || begin[1] == end[1])){
+      // a device with no rows gets a small share again to be measured
+      share = std::clamp(share, 1.0/blocks, 1.0 - 1.0/blocks);
+    }
+  }
+
+private:
+  // rows begin to end are computed into the first end - begin rows of the
+  // device allocation
+  template<typename Kernel_name, typename Kernel_type>
+  void launch(int d, size_t begin, size_t end, size_t cols, size_t local, double* host_out,
+              Kernel_type kernel, sycl::event& computed, sycl::event& copied){
+    const size_t rows = end - begin;
+
+    if(out[d] == nullptr || out_rows[d] < rows){
+      if(out[d] != nullptr) sycl::free(out[d], Q[d]);
+      out[d] = sycl::malloc_device<double>(rows*cols, Q[d]);
+      out_rows[d] = rows;
+    }
+
+    double* A = out[d];
+
+    sycl::nd_range<2> part{sycl::range<2>{rows, cols}, sycl::range<2>{local, local}};
+
+    computed = Q[d].parallel_for<Kernel_name>(part, [=](sycl::nd_item<2> it){
+      const size_t r = it.get_global_id(0);
+      const size_t j = it.get_global_id(1);
+      A[r*cols + j] = kernel(begin + r, j);
+    });
+
+    copied = Q[d].memcpy(host_out + begin*cols, A, rows*cols*sizeof(double), computed);
+  }
+
+  std::vector<sycl::queue> Q;
+  double* out[2] = {nullptr, nullptr};
+  size_t out_rows[2] = {0, 0};
+  bool alive[2] = {true, true};
+  double share = 0.5;
+};
+
+// kernel name of the co-execution example
+class co_execution_kernel;
+
+// co-execution of one nd_range over the default and the cpu device
+void co_execution(){
+  constexpr size_t rows  = 1024;
+  constexpr size_t cols  = 1024;
+  constexpr size_t preferred_local = 16;
+  constexpr int iterations = 5;
+
+  co_executor executor{sycl::device{sycl::default_selector_v}, sycl::device{sycl::cpu_selector_v}};
+
+  std::vector<double> host_out(rows*cols);
+
+  try{
+    for(int it = 0; it < iterations; ++it){
+      executor.run<co_execution_kernel>(rows, cols, preferred_local, host_out.data(), [](size_t i, size_t j){
+        return double(i + j);
+      });
+
+      std::cout << "Iteration " << it << " primary share: " << executor.primary_share() << std::endl;
+    }
+  } catch(std::exception& e){
+    std::cout << "Co-execution stopped: " << e.what() << std::endl;
+    return;
+  }
+
+  for(size_t i = 0; i < rows; ++i){
+    for(size_t j = 0; j < cols; ++j){
+      assert(host_out[i*cols + j] == i + j);
+    }
+  }
+
+  std::cout << "The co-execution answers are correct!" << std::endl;
+}
+
 int main(){
   // dimensional values
   constexpr size_t N_global = 16;
-  constexpr size_t N_local  = 16;
 
   // tolerance
   constexpr double tol = 10E-6;
@@ -33,6 +224,11 @@ int main(){
   print_device(Q_default, "Default Device Selector");
   print_device(Q_gpu,     "GPU Device Selector");
 
+  // local size fitting both the primary and the fallback device
+  const size_t N_local = std::min(
+    pick_square_local_size(Q_gpu, kernel_work_group_limit<fallback_kernel>(Q_gpu), N_global, N_global, 16),
+    pick_square_local_size(Q_default, kernel_work_group_limit<fallback_kernel>(Q_default), N_global, N_global, 16));
+
   // work group range
   sycl::nd_range wg_range{sycl::range{N_global, N_global}, sycl::range{N_local, N_local}};
 
@@ -40,7 +236,7 @@ int main(){
   Q_gpu.submit([&](sycl::handler& h){
     sycl::accessor device_accessor{buffer, h};
 
-    h.parallel_for(wg_range, [=](auto idx){
+    h.parallel_for<fallback_kernel>(wg_range, [=](auto idx){
       auto global_id = idx.get_global_id();
       device_accessor[global_id] = global_id[0] + global_id[1];
     });
@@ -56,5 +252,9 @@ int main(){
   }
 
   std::cout << "The answers are correct!" << std::endl;
+
+  // splitting the work over both devices instead of falling back
+  co_execution();
+
   return 0;
 }
\ No newline at end of file
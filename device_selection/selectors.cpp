@@ -1,5 +1,14 @@
 #include <CL/sycl.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 // prints device name
 template<typename Queue_type, typename String_type>
@@ -68,11 +77,179 @@ void amd_device_selection(){
   print_device(Q, "AMD Device Selector");
 }
 
+// workload classes ranked by the performance selector
+enum class workload_class{
+  memory_bound,
+  compute_bound
+};
+
+// measured device throughput, zero for a device that failed the benchmarks
+struct device_performance{
+  double bandwidth;   // GB/s
+  double flops;       // GFLOP/s
+
+  bool failed() const{
+    return bandwidth <= 0.0 || flops <= 0.0;
+  }
+};
+
+// cache key of a device, a driver update invalidates the entry
+std::string device_key(const sycl::device &D){
+  return D.get_platform().get_info<sycl::info::platform::name>() + "|" +
+         D.get_info<sycl::info::device::name>() + "|" +
+         D.get_info<sycl::info::device::driver_version>();
+}
+
+// best time of a few runs of a submission in ns
+template<typename Queue_type, typename Submit_type>
+double best_time(Queue_type &Q, Submit_type submit){
+  using ns = std::chrono::nanoseconds;
+  ns::rep min_time = std::numeric_limits<ns::rep>::max();
+
+  // warming up the kernel
+  submit(Q).wait();
+
+  for(int a = 0; a < 3; ++a){
+    auto start_time = std::chrono::steady_clock::now();
+    submit(Q).wait();
+    auto interval = std::chrono::steady_clock::now() - start_time;
+
+    min_time = std::min(std::chrono::duration_cast<ns>(interval).count(), min_time);
+  }
+
+  return static_cast<double>(min_time);
+}
+
+// short bandwidth and flop micro benchmarks, floats so every device runs them
+device_performance benchmark_device(const sycl::device &D){
+  constexpr size_t n = 1 << 22;
+  constexpr int chain = 256;
+
+  sycl::queue Q{D};
+
+  // freeing the allocations when a benchmark throws
+  auto free_device = [&Q](float *ptr){ sycl::free(ptr, Q); };
+  std::unique_ptr<float, decltype(free_device)> A_memory{sycl::malloc_device<float>(n, Q), free_device};
+  std::unique_ptr<float, decltype(free_device)> B_memory{sycl::malloc_device<float>(n, Q), free_device};
+
+  if(!A_memory || !B_memory){
+    throw sycl::exception(sycl::make_error_code(sycl::errc::memory_allocation),
+                          "Cannot allocate the benchmark arrays");
+  }
+
+  float *A = A_memory.get();
+  float *B = B_memory.get();
+  Q.fill(A, 1.0f, n).wait();
+
+  // streaming copy, one read and one write per element
+  const double copy_time = best_time(Q, [=](sycl::queue &Q){
+    return Q.parallel_for(n, [=](sycl::id<1> idx){
+      B[idx] = A[idx];
+    });
+  });
+
+  // chain of fused multiply adds, two flops each
+  const double fma_time = best_time(Q, [=](sycl::queue &Q){
+    return Q.parallel_for(n, [=](sycl::id<1> idx){
+      float x = A[idx];
+      for(int c = 0; c < chain; ++c){
+        x = sycl::fma(x, 0.999f, 0.001f);
+      }
+      B[idx] = x;
+    });
+  });
+
+  return {2.0*n*sizeof(float)/copy_time, 2.0*chain*n/fma_time};
+}
+
+// reads the performance cache, one tab separated line per device
+std::map<std::string, device_performance> load_performance_cache(const std::string &path){
+  std::map<std::string, device_performance> cache;
+  std::ifstream in{path};
+  std::string key;
+
+  while(std::getline(in, key, '\t')){
+    device_performance performance;
+    in >> performance.bandwidth >> performance.flops;
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    cache[key] = performance;
+  }
+
+  return cache;
+}
+
+void save_performance_cache(const std::string &path,
+                            const std::map<std::string, device_performance> &cache){
+  std::ofstream out{path};
+  for(auto &[key, performance] : cache){
+    out << key << '\t' << performance.bandwidth << ' ' << performance.flops << '\n';
+  }
+}
+
+// ranks every device by its measured throughput for a workload class,
+// devices that fail to run the benchmarks are cached as failed and never
+// selected
+class performance_selector{
+public:
+  explicit performance_selector(workload_class workload,
+                                const std::string &cache_path = "device_performance.cache"){
+    auto cache = load_performance_cache(cache_path);
+    bool updated = false;
+
+    for(auto &D : sycl::device::get_devices()){
+      const std::string key = device_key(D);
+
+      if(cache.count(key) == 0){
+        try{
+          cache[key] = benchmark_device(D);
+        } catch(sycl::exception &e){
+          cache[key] = {0.0, 0.0};
+        }
+        updated = true;
+      }
+
+      const auto &performance = cache[key];
+      if(performance.failed()) continue;
+
+      ranked.push_back({D, workload == workload_class::memory_bound ? performance.bandwidth
+                                                                    : performance.flops});
+    }
+
+    if(updated){
+      save_performance_cache(cache_path, cache);
+    }
+
+    std::sort(ranked.begin(), ranked.end(), [](auto &a, auto &b){
+      return a.second < b.second;
+    });
+  }
+
+  int operator()(const sycl::device &D) const{
+    for(size_t r = 0; r < ranked.size(); ++r){
+      if(ranked[r].first == D) return r + 1;
+    }
+    return -1;
+  }
+
+private:
+  std::vector<std::pair<sycl::device, double>> ranked;
+};
+
+// selects the fastest device for each workload class
+void performance_device_selection(){
+  sycl::queue Q_memory{performance_selector{workload_class::memory_bound}};
+  print_device(Q_memory, "Memory Bound Performance Selector");
+
+  sycl::queue Q_compute{performance_selector{workload_class::compute_bound}};
+  print_device(Q_compute, "Compute Bound Performance Selector");
+}
+
 int main(){
   //implicit_selector();
   //default_selector();
   //gpu_selector();
   //multiple_device_selector();
-  nvidia_device_selection();
+  //nvidia_device_selection();
   //amd_device_selection();
+  performance_device_selection();
 }
\ No newline at end of file
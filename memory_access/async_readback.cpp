@@ -0,0 +1,95 @@
+#include <CL/sycl.hpp>
+#include <array>
+#include <iostream>
+#include <assert.h>
+
+#include "../telemetry/telemetry.hpp"
+#include "host_stall_log.hpp"
+
+constexpr int SIZE = 256;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// enqueues a copy of a buffer into host memory and returns its event,
+// unlike a host accessor the host thread keeps running
+template<typename Queue_type, typename Scalar_type, int Dims>
+sycl::event async_readback(Queue_type& Q, sycl::buffer<Scalar_type, Dims>& buffer,
+                           Scalar_type* host_dst){
+  return telemetry::submit(Q, [&](sycl::handler &h){
+    sycl::accessor accessor{buffer, h, sycl::read_only};
+    h.copy(accessor, host_dst);
+  });
+}
+
+template<typename Queue_type>
+void async_readback_test(Queue_type Q){
+  // arrays on host memory
+  std::array<int, SIZE> Arr1_host;
+  std::array<int, SIZE> Arr2_host;
+  std::array<int, SIZE> Arr2_result;
+
+  // initializing host arrays
+  for(int i = 0; i < SIZE; ++i){
+    Arr1_host[i] = i;
+    Arr2_host[i] = 0;
+  }
+
+  // establishing memory buffers
+  sycl::buffer Arr1_buffer{Arr1_host};
+  sycl::buffer Arr2_buffer{Arr2_host};
+
+  // producing the result
+  telemetry::submit(Q, [&](sycl::handler &h){
+    sycl::accessor Arr1_accessor(Arr1_buffer, h, sycl::read_only);
+    sycl::accessor Arr2_accessor(Arr2_buffer, h, sycl::write_only, sycl::no_init);
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      Arr2_accessor[idx] = Arr1_accessor[idx]*Arr1_accessor[idx];
+    });
+  });
+
+  // reading the result back without blocking
+  auto readback = async_readback(Q, Arr2_buffer, Arr2_result.data());
+
+  // the host keeps submitting independent work
+  telemetry::submit(Q, [&](sycl::handler &h){
+    sycl::accessor Arr1_accessor(Arr1_buffer, h, sycl::read_write);
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      Arr1_accessor[idx] += 1;
+    });
+  });
+
+  readback.wait();
+
+  for(int i = 0; i < SIZE; ++i){
+    assert(Arr2_result[i] == i*i);
+  }
+
+  // the logged host accessor blocks until the increment is done
+  auto Arr1_host_accessor = logged_host_accessor(Arr1_buffer, "Arr1_buffer", sycl::read_only);
+
+  for(int i = 0; i < SIZE; ++i){
+    assert(Arr1_host_accessor[i] == i + 1);
+  }
+
+  stall_log.print();
+
+  std::cout << "Async readback results passed!" << std::endl;
+}
+
+int main(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  async_readback_test(Q);
+
+  return 0;
+}
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+#include "host_stall_log.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -32,7 +35,7 @@ int main(){
   sycl::buffer Arr_buffer(Arr_host);
 
   // incrementing array values on device
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr_accessor(Arr_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -42,7 +45,7 @@ int main(){
 
   Q.wait();
 
-  sycl::host_accessor Arr_host_accessor(Arr_buffer);
+  auto Arr_host_accessor = logged_host_accessor(Arr_buffer, "Arr_buffer");
 
   // checking results
   for(int i = 0; i < SIZE; ++i){
@@ -51,5 +54,7 @@ int main(){
 
   std::cout << "The results are correct!" << std::endl;
 
+  stall_log.print();
+
   return 0;
 }
\ No newline at end of file
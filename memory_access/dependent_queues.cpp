@@ -3,6 +3,8 @@
 #include <iostream>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -38,7 +40,7 @@ int main(){
   sycl::buffer Arr3_buffer(Arr3_host);
 
   // incrementing array 1 values on device by 1
-  auto event1 = Q.submit([&](sycl::handler &h){
+  auto event1 = telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr1_accessor(Arr1_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -49,7 +51,7 @@ int main(){
   event1.wait();
 
   // subtracting array 2 values on device by 1
-  auto event2 = Q.submit([&](sycl::handler &h){
+  auto event2 = telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr2_accessor(Arr2_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -58,7 +60,7 @@ int main(){
   });
 
   // adding array 1 and array 2
-  auto event3 = Q.submit([&](sycl::handler &h){
+  auto event3 = telemetry::submit(Q, [&](sycl::handler &h){
     h.depends_on(event2);
     sycl::accessor Arr1_accessor(Arr1_buffer, h);
     sycl::accessor Arr2_accessor(Arr2_buffer, h);
@@ -70,7 +72,7 @@ int main(){
   });
 
   // increment array 1 twice
-  auto event4 = Q.submit([&](sycl::handler &h){
+  auto event4 = telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr1_accessor(Arr1_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -79,7 +81,7 @@ int main(){
   });
 
   // add the new array 1 to the sum
-  auto event5 = Q.submit([&](sycl::handler &h){
+  auto event5 = telemetry::submit(Q, [&](sycl::handler &h){
     h.depends_on({event3, event4});
     sycl::accessor Arr1_accessor(Arr1_buffer, h);
     sycl::accessor Arr3_accessor(Arr3_buffer, h);
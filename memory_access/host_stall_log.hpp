@@ -0,0 +1,50 @@
+#pragma once
+
+// host accessors that log how long their construction blocked the host,
+// a host accessor waits for every pending command writing its buffer
+#include <CL/sycl.hpp>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// time each host accessor construction spent blocked
+class host_stall_log{
+public:
+  void add(const std::string& label, long long ns){
+    std::lock_guard<std::mutex> guard{mtx};
+    entries.push_back({label, ns});
+  }
+
+  void print(){
+    std::lock_guard<std::mutex> guard{mtx};
+    for(auto& e : entries){
+      std::cout << "host_accessor " << e.label << " blocked " << e.ns << " ns" << std::endl;
+    }
+  }
+
+private:
+  struct entry{
+    std::string label;
+    long long ns;
+  };
+
+  std::mutex mtx;
+  std::vector<entry> entries;
+};
+
+inline host_stall_log stall_log;
+
+// constructs a host accessor and logs how long the construction blocked
+template<typename Buffer_type, typename... Arg_types>
+auto logged_host_accessor(Buffer_type& buffer, const std::string& label, Arg_types... args){
+  using ns = std::chrono::nanoseconds;
+
+  auto start_time = std::chrono::steady_clock::now();
+  sycl::host_accessor accessor{buffer, args...};
+  auto interval = std::chrono::steady_clock::now() - start_time;
+
+  stall_log.add(label, std::chrono::duration_cast<ns>(interval).count());
+  return accessor;
+}
@@ -0,0 +1,290 @@
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../telemetry/telemetry.hpp"
+
+// number of values in the test files
+constexpr size_t SIZE = 1 << 20;
+
+// number of values per staging chunk
+constexpr size_t chunk_size = 1 << 16;
+
+// result tolerance
+constexpr double tol = 1.0E-6;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// read only memory mapping of a raw binary file of Scalar_type values
+template<typename Scalar_type>
+class mapped_file{
+public:
+  explicit mapped_file(const std::string& path){
+    fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+      throw std::runtime_error("Cannot open " + path);
+    }
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0){
+      close(fd);
+      throw std::runtime_error("Cannot stat " + path);
+    }
+    bytes = file_stat.st_size;
+
+    if(bytes > 0){
+      ptr = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(ptr == MAP_FAILED){
+        close(fd);
+        throw std::runtime_error("Cannot map " + path);
+      }
+
+      // inputs are consumed front to back
+      madvise(ptr, bytes, MADV_SEQUENTIAL);
+    }
+  }
+
+  ~mapped_file(){
+#ifdef SYCL_EXT_ONEAPI_COPY_OPTIMIZE
+    if(registered_queue){
+      sycl::ext::oneapi::experimental::release_from_device_copy(ptr, *registered_queue);
+    }
+#endif
+    if(ptr != nullptr) munmap(ptr, bytes);
+    close(fd);
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  const Scalar_type* data() const{
+    return static_cast<const Scalar_type*>(ptr);
+  }
+
+  size_t size() const{
+    return bytes/sizeof(Scalar_type);
+  }
+
+  // buffer using the mapping as its host memory, nothing is written back
+  sycl::buffer<Scalar_type, 1> as_buffer() const{
+    return sycl::buffer<Scalar_type, 1>{data(), sycl::range{size()},
+                                        {sycl::property::buffer::use_host_ptr{}}};
+  }
+
+  // pins the pages of the mapping so usm copies from it skip the staging
+  // copy, the data is still copied to the device
+  //   - returns false when the runtime has no support for registration or
+  //     the mapping is empty
+  template<typename Queue_type>
+  bool register_host(Queue_type& Q){
+#ifdef SYCL_EXT_ONEAPI_COPY_OPTIMIZE
+    if(ptr == nullptr) return false;
+
+    if(!registered_queue){
+      sycl::ext::oneapi::experimental::prepare_for_device_copy(ptr, bytes, Q);
+      registered_queue = Q;
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+private:
+  int fd = -1;
+  size_t bytes = 0;
+  void* ptr = nullptr;
+  std::optional<sycl::queue> registered_queue;
+};
+
+// writes device usm results to a file through two host usm staging chunks,
+// the copy of the next chunk overlaps the file write of the current one
+template<typename Scalar_type>
+class streaming_writer{
+public:
+  streaming_writer(sycl::queue& Q, const std::string& path, size_t chunk)
+    : Q{Q}, out{path, std::ios::binary}, chunk{chunk}{
+    if(!out){
+      throw std::runtime_error("Cannot open " + path);
+    }
+
+    staging[0] = telemetry::malloc_host<Scalar_type>(chunk, Q);
+    staging[1] = telemetry::malloc_host<Scalar_type>(chunk, Q);
+  }
+
+  ~streaming_writer(){
+    telemetry::free(staging[0], Q);
+    telemetry::free(staging[1], Q);
+  }
+
+  streaming_writer(const streaming_writer&) = delete;
+  streaming_writer& operator=(const streaming_writer&) = delete;
+
+  // appends n values from device memory to the file
+  void write(const Scalar_type* device_ptr, size_t n){
+    if(n == 0) return;
+
+    auto copy_chunk = [&](int slot, size_t offset){
+      const size_t count = std::min(chunk, n - offset);
+      return telemetry::memcpy(Q, staging[slot], device_ptr + offset, count*sizeof(Scalar_type));
+    };
+
+    sycl::event copied = copy_chunk(0, 0);
+
+    for(size_t offset = 0, k = 0; offset < n; offset += chunk, ++k){
+      const int slot = k%2;
+      const size_t count = std::min(chunk, n - offset);
+
+      copied.wait();
+
+      if(offset + chunk < n){
+        copied = copy_chunk(1 - slot, offset + chunk);
+      }
+
+      out.write(reinterpret_cast<const char*>(staging[slot]), count*sizeof(Scalar_type));
+    }
+  }
+
+private:
+  sycl::queue Q;
+  std::ofstream out;
+  size_t chunk;
+  Scalar_type* staging[2];
+};
+
+// writes a test input file chunk by chunk
+template<typename Scalar_type, typename Function_type>
+void write_test_file(const std::string& path, size_t n, Function_type f){
+  std::ofstream out{path, std::ios::binary};
+  std::vector<Scalar_type> chunk(chunk_size);
+
+  for(size_t offset = 0; offset < n; offset += chunk_size){
+    const size_t count = std::min(chunk_size, n - offset);
+    for(size_t i = 0; i < count; ++i){
+      chunk[i] = f(offset + i);
+    }
+    out.write(reinterpret_cast<const char*>(chunk.data()), count*sizeof(Scalar_type));
+  }
+}
+
+// checks the output file of a vector addition
+void check_output_file(const std::string& path){
+  mapped_file<double> C{path};
+  assert(C.size() == SIZE);
+
+  for(size_t i = 0; i < C.size(); ++i){
+    assert(fabs(C.data()[i] - (0.5*i + 2.0)) < tol);
+  }
+}
+
+// vector addition reading the mapped inputs through buffers
+template<typename Queue_type>
+void mapped_buffer_addition(Queue_type Q, const std::string& A_path,
+                            const std::string& B_path, const std::string& C_path){
+  mapped_file<double> A{A_path};
+  mapped_file<double> B{B_path};
+  assert(B.size() == A.size());
+  const size_t n = A.size();
+
+  double *C_device = telemetry::malloc_device<double>(n, Q);
+
+  {
+    auto A_buffer = A.as_buffer();
+    auto B_buffer = B.as_buffer();
+
+    telemetry::submit(Q, [&](sycl::handler &h){
+      sycl::accessor A_accessor{A_buffer, h, sycl::read_only};
+      sycl::accessor B_accessor{B_buffer, h, sycl::read_only};
+      h.parallel_for(n, [=](sycl::id<1> idx){
+        C_device[idx] = A_accessor[idx] + B_accessor[idx];
+      });
+    });
+  }
+
+  Q.wait();
+
+  streaming_writer<double> writer{Q, C_path, chunk_size};
+  writer.write(C_device, n);
+
+  telemetry::free(C_device, Q);
+}
+
+// vector addition copying the pinned mappings into device usm
+template<typename Queue_type>
+void mapped_usm_addition(Queue_type Q, const std::string& A_path,
+                         const std::string& B_path, const std::string& C_path){
+  mapped_file<double> A{A_path};
+  mapped_file<double> B{B_path};
+  assert(B.size() == A.size());
+  const size_t n = A.size();
+
+  const bool registered = A.register_host(Q) && B.register_host(Q);
+  std::cout << "Host registration: " << (registered ? "pinned" : "not pinned") << std::endl;
+
+  double *A_device = telemetry::malloc_device<double>(n, Q);
+  double *B_device = telemetry::malloc_device<double>(n, Q);
+  double *C_device = telemetry::malloc_device<double>(n, Q);
+
+  auto A_copied = telemetry::memcpy(Q, A_device, A.data(), n*sizeof(double));
+  auto B_copied = telemetry::memcpy(Q, B_device, B.data(), n*sizeof(double));
+
+  telemetry::parallel_for(Q, sycl::range{n}, std::vector{A_copied, B_copied}, [=](sycl::id<1> idx){
+    C_device[idx] = A_device[idx] + B_device[idx];
+  }).wait();
+
+  {
+    streaming_writer<double> writer{Q, C_path, chunk_size};
+    writer.write(C_device, n);
+  }
+
+  telemetry::free(A_device, Q);
+  telemetry::free(B_device, Q);
+  telemetry::free(C_device, Q);
+}
+
+int main(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  const std::string A_path = "mapped_A.bin";
+  const std::string B_path = "mapped_B.bin";
+  const std::string C_path = "mapped_C.bin";
+
+  // creating the input files
+  write_test_file<double>(A_path, SIZE, [](size_t i){ return 0.5*i; });
+  write_test_file<double>(B_path, SIZE, [](size_t i){ return 2.0; });
+
+  mapped_buffer_addition(Q, A_path, B_path, C_path);
+  check_output_file(C_path);
+  std::cout << "The mapped buffer results are correct!" << std::endl;
+
+  mapped_usm_addition(Q, A_path, B_path, C_path);
+  check_output_file(C_path);
+  std::cout << "The mapped usm results are correct!" << std::endl;
+
+  std::remove(A_path.c_str());
+  std::remove(B_path.c_str());
+  std::remove(C_path.c_str());
+
+  return 0;
+}
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -15,6 +17,31 @@ void print_device(Queue_type& Q){
             << "\n" << std::endl;
 }
 
+// composes elementwise stages into one stage applied left to right,
+// the composition is a single lambda so the compiler fuses the bodies
+template<typename... Stage_types>
+auto fuse(Stage_types... stages){
+  return [=](auto x){
+    ((x = stages(x)), ...);
+    return x;
+  };
+}
+
+// submits one kernel per stage group over the buffer
+//   - a group is an elementwise stage, usually made with fuse
+//   - stages that need every previous stage to finish on the whole buffer
+//     start a new group, the buffer accessors order the groups
+template<typename Queue_type, typename Buffer_type, typename... Group_types>
+void submit_stage_groups(Queue_type& Q, Buffer_type& buffer, Group_types... groups){
+  (telemetry::submit(Q, [&](sycl::handler &h){
+    sycl::accessor Arr_accessor(buffer, h);
+
+    h.parallel_for(buffer.get_range(), [=](sycl::id<1> idx){
+      Arr_accessor[idx] = groups(Arr_accessor[idx]);
+    });
+  }), ...);
+}
+
 int main(){
   // establishing gpu for device queue
   sycl::queue Q{sycl::gpu_selector_v};
@@ -32,7 +59,7 @@ int main(){
   sycl::buffer Arr_buffer(Arr_host);
 
   // incrementing array values on device by 1
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr_accessor(Arr_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -43,7 +70,7 @@ int main(){
   Q.wait();
 
   // doubling array values on device
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr_accessor(Arr_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -54,7 +81,7 @@ int main(){
   Q.wait();
 
   // incrementing array values on device by 3
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr_accessor(Arr_buffer, h);
 
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -73,5 +100,38 @@ int main(){
 
   std::cout << "The results are correct!" << std::endl;
 
+  // the same stages fused into one kernel with a single wait
+  auto increment = [](auto x){ return x + 1; };
+  auto twice     = [](auto x){ return x*2; };
+  auto add_three = [](auto x){ return x + 3; };
+
+  std::array<int, SIZE> Fused_host;
+  std::array<int, SIZE> Split_host;
+
+  for(int i = 0; i < SIZE; ++i){
+    Fused_host[i] = i;
+    Split_host[i] = i;
+  }
+
+  {
+    sycl::buffer Fused_buffer(Fused_host);
+    sycl::buffer Split_buffer(Split_host);
+
+    submit_stage_groups(Q, Fused_buffer, fuse(increment, twice, add_three));
+
+    // opting out of fusion, the last stage runs after a global barrier
+    submit_stage_groups(Q, Split_buffer, fuse(increment, twice), add_three);
+
+    Q.wait();
+  }
+
+  // checking results
+  for(int i = 0; i < SIZE; ++i){
+    assert(Fused_host[i] == (i + 1.0)*2.0 + 3.0);
+    assert(Split_host[i] == (i + 1.0)*2.0 + 3.0);
+  }
+
+  std::cout << "The fused results are correct!" << std::endl;
+
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include <CL/sycl.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <assert.h>
+
+#include "../telemetry/telemetry.hpp"
+
+// number of values per batch
+constexpr size_t batch_size = 1 << 16;
+
+// number of batches
+constexpr size_t batches = 32;
+
+// number of device slots in the ring
+constexpr size_t slots = 3;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// batch pipeline over a ring of device slots
+//   - upload, compute and download run on their own in order queues
+//   - batch i+1 uploads while batch i computes and batch i-1 downloads
+//   - a slot is reused only after the download of its previous batch
+template<typename Scalar_type>
+class batch_pipeline{
+public:
+  batch_pipeline(sycl::queue& Q, size_t batch_size, size_t slots)
+    : Q_upload{Q.get_context(), Q.get_device(), sycl::property::queue::in_order()},
+      Q_compute{Q.get_context(), Q.get_device(), sycl::property::queue::in_order()},
+      Q_download{Q.get_context(), Q.get_device(), sycl::property::queue::in_order()},
+      batch_size{batch_size}{
+    for(size_t s = 0; s < slots; ++s){
+      ring.push_back(telemetry::malloc_device<Scalar_type>(batch_size, Q_compute));
+    }
+  }
+
+  ~batch_pipeline(){
+    for(auto slot : ring){
+      telemetry::free(slot, Q_compute);
+    }
+  }
+
+  batch_pipeline(const batch_pipeline&) = delete;
+  batch_pipeline& operator=(const batch_pipeline&) = delete;
+
+  // runs kernel(A, i) over every batch of input and stores it in output,
+  // the host arrays should be host usm so the copies are asynchronous
+  template<typename Kernel_type>
+  void run(const Scalar_type* input, Scalar_type* output, size_t batches, Kernel_type kernel){
+    const size_t bytes = batch_size*sizeof(Scalar_type);
+    std::vector<sycl::event> downloaded(ring.size());
+
+    for(size_t b = 0; b < batches; ++b){
+      const size_t s = b%ring.size();
+      Scalar_type* slot = ring[s];
+
+      auto uploaded = telemetry::memcpy(Q_upload, slot, input + b*batch_size, bytes, downloaded[s]);
+
+      auto computed = telemetry::parallel_for(Q_compute, sycl::range{batch_size}, uploaded,
+                                             [=](sycl::id<1> idx){
+        kernel(slot, idx[0]);
+      });
+
+      downloaded[s] = telemetry::memcpy(Q_download, output + b*batch_size, slot, bytes, computed);
+    }
+
+    Q_download.wait();
+  }
+
+private:
+  sycl::queue Q_upload;
+  sycl::queue Q_compute;
+  sycl::queue Q_download;
+  size_t batch_size;
+  std::vector<Scalar_type*> ring;
+};
+
+// batch processing with a wait after every stage
+template<typename Queue_type, typename Scalar_type, typename Kernel_type>
+void serial_batches(Queue_type& Q, const Scalar_type* input, Scalar_type* output,
+                    size_t batches, Kernel_type kernel){
+  const size_t bytes = batch_size*sizeof(Scalar_type);
+  Scalar_type* slot = telemetry::malloc_device<Scalar_type>(batch_size, Q);
+
+  for(size_t b = 0; b < batches; ++b){
+    telemetry::memcpy(Q, slot, input + b*batch_size, bytes).wait();
+
+    telemetry::parallel_for(Q, sycl::range{batch_size}, [=](sycl::id<1> idx){
+      kernel(slot, idx[0]);
+    }).wait();
+
+    telemetry::memcpy(Q, output + b*batch_size, slot, bytes).wait();
+  }
+
+  telemetry::free(slot, Q);
+}
+
+int main(){
+  using ns = std::chrono::nanoseconds;
+
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  const size_t n = batch_size*batches;
+
+  // pinned host memory
+  int *input  = telemetry::malloc_host<int>(n, Q);
+  int *output = telemetry::malloc_host<int>(n, Q);
+
+  for(size_t i = 0; i < n; ++i){
+    input[i] = i%1024;
+  }
+
+  auto kernel = [](int* A, size_t i){
+    A[i] = A[i]*A[i] + 1;
+  };
+
+  batch_pipeline<int> pipeline{Q, batch_size, slots};
+
+  // warming up both paths, the first run pays for the jit compilation and
+  // the first touch of the allocations
+  serial_batches(Q, input, output, slots, kernel);
+  pipeline.run(input, output, slots, kernel);
+
+  // serial sum of stages
+  auto start_time = std::chrono::steady_clock::now();
+  serial_batches(Q, input, output, batches, kernel);
+  auto serial_interval = std::chrono::steady_clock::now() - start_time;
+
+  for(size_t i = 0; i < n; ++i){
+    assert(output[i] == static_cast<int>((i%1024)*(i%1024) + 1));
+    output[i] = 0;
+  }
+
+  // overlapped stages
+  start_time = std::chrono::steady_clock::now();
+  pipeline.run(input, output, batches, kernel);
+  auto pipeline_interval = std::chrono::steady_clock::now() - start_time;
+
+  std::cout << "Serial batches:    "
+            << std::chrono::duration_cast<ns>(serial_interval).count() << " ns\n"
+            << "Pipelined batches: "
+            << std::chrono::duration_cast<ns>(pipeline_interval).count() << " ns" << std::endl;
+
+  for(size_t i = 0; i < n; ++i){
+    assert(output[i] == static_cast<int>((i%1024)*(i%1024) + 1));
+  }
+
+  std::cout << "The pipeline results are correct!" << std::endl;
+
+  telemetry::free(input, Q);
+  telemetry::free(output, Q);
+  return 0;
+}
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+#include "host_stall_log.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -35,7 +38,7 @@ void read_write_test_1(Queue_type Q){
   sycl::buffer Arr3_buffer{Arr3_host};
 
   // first kernel execution
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr1_accessor(Arr1_buffer, h, sycl::read_only);
     sycl::accessor Arr2_accessor(Arr2_buffer, h, sycl::write_only);
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -44,7 +47,7 @@ void read_write_test_1(Queue_type Q){
   }).wait();
 
   // second kernel execution
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr1_accessor(Arr1_buffer, h, sycl::read_only);
     sycl::accessor Arr2_accessor(Arr2_buffer, h, sycl::read_only);
     sycl::accessor Arr3_accessor(Arr3_buffer, h, sycl::read_write);
@@ -54,9 +57,9 @@ void read_write_test_1(Queue_type Q){
   }).wait();
 
   // reading memory on host
-  sycl::host_accessor Arr1_host_accessor(Arr1_buffer, sycl::read_only);
-  sycl::host_accessor Arr2_host_accessor(Arr2_buffer, sycl::read_only);
-  sycl::host_accessor Arr3_host_accessor(Arr3_buffer, sycl::read_only);
+  auto Arr1_host_accessor = logged_host_accessor(Arr1_buffer, "Arr1_buffer", sycl::read_only);
+  auto Arr2_host_accessor = logged_host_accessor(Arr2_buffer, "Arr2_buffer", sycl::read_only);
+  auto Arr3_host_accessor = logged_host_accessor(Arr3_buffer, "Arr3_buffer", sycl::read_only);
 
   for(int i = 0; i < SIZE; ++i){
     assert(Arr1_host_accessor[i] == i);
@@ -87,7 +90,7 @@ void read_write_test_2(Queue_type Q){
   sycl::buffer Arr3_buffer{Arr3_host};
 
   // first kernel execution
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr1_accessor(Arr1_buffer, h, sycl::read_only);
     sycl::accessor Arr2_accessor(Arr2_buffer, h, sycl::write_only);
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -96,7 +99,7 @@ void read_write_test_2(Queue_type Q){
   }).wait();
 
   // second kernel execution
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr1_accessor(Arr1_buffer, h, sycl::read_only);
     sycl::accessor Arr2_accessor(Arr2_buffer, h, sycl::read_only);
     sycl::accessor Arr3_accessor(Arr3_buffer, h, sycl::read_write);
@@ -106,7 +109,7 @@ void read_write_test_2(Queue_type Q){
   }).wait();
 
   // second kernel execution
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     sycl::accessor Arr2_accessor(Arr2_buffer, h, sycl::write_only);
     sycl::accessor Arr3_accessor(Arr3_buffer, h, sycl::write_only);
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
@@ -116,9 +119,9 @@ void read_write_test_2(Queue_type Q){
   }).wait();
 
   // reading memory on host
-  sycl::host_accessor Arr1_host_accessor(Arr1_buffer, sycl::read_only);
-  sycl::host_accessor Arr2_host_accessor(Arr2_buffer, sycl::read_only);
-  sycl::host_accessor Arr3_host_accessor(Arr3_buffer, sycl::read_only);
+  auto Arr1_host_accessor = logged_host_accessor(Arr1_buffer, "Arr1_buffer", sycl::read_only);
+  auto Arr2_host_accessor = logged_host_accessor(Arr2_buffer, "Arr2_buffer", sycl::read_only);
+  auto Arr3_host_accessor = logged_host_accessor(Arr3_buffer, "Arr3_buffer", sycl::read_only);
 
   for(int i = 0; i < SIZE; ++i){
     assert(Arr1_host_accessor[i] == i);
@@ -138,5 +141,7 @@ int main(){
   read_write_test_1(Q);
   read_write_test_2(Q);
 
+  stall_log.print();
+
   return 0;
 }
\ No newline at end of file
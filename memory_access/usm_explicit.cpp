@@ -3,6 +3,8 @@
 #include <iostream>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -24,7 +26,7 @@ int main(){
   std::array<int, SIZE> Arr_host;
 
   // allocating memory on device
-  int *Arr_device = sycl::malloc_device<int>(SIZE, Q);
+  int *Arr_device = telemetry::malloc_device<int>(SIZE, Q);
 
   // filling the host array with index values
   for(int i = 0; i < SIZE; ++i){
@@ -32,14 +34,14 @@ int main(){
   }
 
   // copying host to device
-  Q.submit([&](sycl::handler &h){
-    h.memcpy(Arr_device, &Arr_host[0], SIZE*sizeof(int));
+  telemetry::submit(Q, [&](sycl::handler &h){
+    telemetry::memcpy(h, Arr_device, &Arr_host[0], SIZE*sizeof(int));
   });
 
   Q.wait();
 
   // incrementing array values on device
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
       Arr_device[idx]++;
     });
@@ -48,8 +50,8 @@ int main(){
   Q.wait();
 
   // copying device to host
-  Q.submit([&](sycl::handler &h){
-    h.memcpy(&Arr_host[0], Arr_device, SIZE*sizeof(int));
+  telemetry::submit(Q, [&](sycl::handler &h){
+    telemetry::memcpy(h, &Arr_host[0], Arr_device, SIZE*sizeof(int));
   });
 
   Q.wait();
@@ -61,6 +63,6 @@ int main(){
 
   std::cout << "The results are correct!" << std::endl;
 
-  sycl::free(Arr_device, Q);
+  telemetry::free(Arr_device, Q);
   return 0;
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -21,10 +23,10 @@ int main(){
   print_device(Q);
 
   // allocating memory on host
-  int *Arr_host = sycl::malloc_host<int>(SIZE, Q);
+  int *Arr_host = telemetry::malloc_host<int>(SIZE, Q);
 
   // allocating shared memory between host and device
-  int *Arr_shared = sycl::malloc_shared<int>(SIZE, Q);
+  int *Arr_shared = telemetry::malloc_shared<int>(SIZE, Q);
 
   // filling the host array with index values
   for(int i = 0; i < SIZE; ++i){
@@ -32,7 +34,7 @@ int main(){
   }
 
   // incrementing array values on device
-  Q.submit([&](sycl::handler &h){
+  telemetry::submit(Q, [&](sycl::handler &h){
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
       Arr_shared[idx] = Arr_host[idx] + 1;
     });
@@ -52,7 +54,7 @@ int main(){
 
   std::cout << "The results are correct!" << std::endl;
 
-  sycl::free(Arr_host, Q);
-  sycl::free(Arr_shared, Q);
+  telemetry::free(Arr_host, Q);
+  telemetry::free(Arr_shared, Q);
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include <cassert>
+#include <CL/sycl.hpp>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <optional>
+
+constexpr int SIZE = 64;
+constexpr double tol = 1.0E-6;
+
+// number of replayed iterations
+constexpr int iterations = 1000;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// check random test function
+template<typename Scalar_type, typename Tolerance_type, typename String_type>
+void check_equal(Scalar_type A, Scalar_type B, Tolerance_type tol, String_type name){
+  assert(fabs(A - B) < tol);
+  std::cout << "The " << name << " results are successful!" << std::endl;
+}
+
+// records a fixed sequence of submissions once and replays it
+//   - the queue must be in order so parameter updates and replays are ordered
+//   - scalar arguments live in a device parameter block read by the kernels,
+//     a replay updates the block instead of recording again
+//   - with sycl_ext_oneapi_graph the sequence is finalized into an executable
+//     graph, elsewhere the recorded sequence is submitted again on replay
+template<typename Param_type>
+class command_recording{
+public:
+  using sequence_type = std::function<sycl::event(sycl::queue&)>;
+
+  explicit command_recording(sycl::queue& Q) : Q{Q}{
+    assert(Q.is_in_order());
+    params = sycl::malloc_device<Param_type>(1, Q);
+  }
+
+  ~command_recording(){
+    Q.wait();
+    sycl::free(params, Q);
+  }
+
+  command_recording(const command_recording&) = delete;
+  command_recording& operator=(const command_recording&) = delete;
+
+  // device parameter block to be read by the recorded kernels
+  Param_type* parameters() const{
+    return params;
+  }
+
+  // records the sequence of submissions
+  void record(sequence_type recorded){
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+    namespace exp = sycl::ext::oneapi::experimental;
+
+    exp::command_graph graph{Q.get_context(), Q.get_device()};
+    graph.begin_recording(Q);
+    recorded(Q);
+    graph.end_recording(Q);
+
+    executable.emplace(graph.finalize());
+#endif
+    sequence = std::move(recorded);
+  }
+
+  // replays the recorded sequence with new scalar arguments
+  sycl::event replay(const Param_type& p){
+    // the fill pattern is copied at submission so p need not outlive it
+    Q.fill(params, p, 1);
+
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+    return Q.ext_oneapi_graph(*executable);
+#else
+    return sequence(Q);
+#endif
+  }
+
+  // whether the replay uses a finalized command graph
+  static constexpr bool uses_graph(){
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+    return true;
+#else
+    return false;
+#endif
+  }
+
+private:
+  sycl::queue Q;
+  Param_type* params = nullptr;
+  sequence_type sequence;
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  std::optional<sycl::ext::oneapi::experimental::command_graph<
+    sycl::ext::oneapi::experimental::graph_state::executable>> executable;
+#endif
+};
+
+// scalar arguments of the y pattern
+struct y_parameters{
+  double scale;
+};
+
+// y pattern submitted directly with the scale captured by value
+sycl::event submit_y_pattern(sycl::queue& Q, double* A, double* B, double scale){
+  Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] = i*scale;
+  });
+
+  Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    B[i] = 2*i*scale;
+  });
+
+  Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] += B[i];
+  });
+
+  return Q.single_task([=](){
+    for(int i = 1; i < SIZE; ++i){
+      A[0] += A[i];
+    }
+  });
+}
+
+// y pattern reading the scale from the parameter block
+sycl::event submit_y_pattern(sycl::queue& Q, double* A, double* B, const y_parameters* p){
+  Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] = i*p->scale;
+  });
+
+  Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    B[i] = 2*i*p->scale;
+  });
+
+  Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] += B[i];
+  });
+
+  return Q.single_task([=](){
+    for(int i = 1; i < SIZE; ++i){
+      A[0] += A[i];
+    }
+  });
+}
+
+// per iteration host submission time of direct submission and replay
+void replay_benchmark(){
+  using ns = std::chrono::nanoseconds;
+
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v, sycl::property::queue::in_order()};
+  print_device(Q);
+
+  double *A = sycl::malloc_shared<double>(SIZE, Q);
+  double *B = sycl::malloc_shared<double>(SIZE, Q);
+
+  // scale of the last iteration
+  const double last_scale = iterations;
+  const double result = last_scale*(SIZE)*(SIZE-1.0)*1.5;
+
+  // warming up the kernels
+  submit_y_pattern(Q, A, B, 1.0).wait();
+
+  // direct submission
+  auto start_time = std::chrono::steady_clock::now();
+  for(int it = 1; it <= iterations; ++it){
+    submit_y_pattern(Q, A, B, double(it));
+  }
+  auto submit_interval = std::chrono::steady_clock::now() - start_time;
+  Q.wait();
+
+  check_equal(A[0], result, tol, "Direct Y Pattern");
+
+  const auto direct_ns = std::chrono::duration_cast<ns>(submit_interval).count()/iterations;
+
+  // record once and replay
+  ns::rep replay_ns;
+  {
+    command_recording<y_parameters> recording{Q};
+    const y_parameters* p = recording.parameters();
+
+    recording.record([=](sycl::queue& Q){
+      return submit_y_pattern(Q, A, B, p);
+    });
+
+    recording.replay({1.0}).wait();
+
+    start_time = std::chrono::steady_clock::now();
+    for(int it = 1; it <= iterations; ++it){
+      recording.replay({double(it)});
+    }
+    submit_interval = std::chrono::steady_clock::now() - start_time;
+    Q.wait();
+
+    replay_ns = std::chrono::duration_cast<ns>(submit_interval).count()/iterations;
+
+    check_equal(A[0], result, tol, "Replayed Y Pattern");
+    std::cout << "Replay uses "
+              << (command_recording<y_parameters>::uses_graph() ? "sycl_ext_oneapi_graph"
+                                                                : "resubmission fallback")
+              << std::endl;
+  }
+
+  std::cout << "Direct submit: " << direct_ns << " ns per iteration\n"
+            << "Replay submit: " << replay_ns << " ns per iteration" << std::endl;
+
+  sycl::free(A, Q);
+  sycl::free(B, Q);
+}
+
+int main(){
+  replay_benchmark();
+
+  return 0;
+}
@@ -1,6 +1,8 @@
 #include <cassert>
 #include <CL/sycl.hpp>
 
+#include "../memory_access/host_stall_log.hpp"
+
 constexpr int SIZE = 64;
 constexpr double tol = 1.0E-6;
 
@@ -101,7 +103,7 @@ void buffer_in_order_linear_dependance(){
     });
   });
 
-  sycl::host_accessor A_host{A_buffer};
+  auto A_host = logged_host_accessor(A_buffer, "A_buffer");
 
   const double result = (SIZE)*(SIZE-1.0)*0.5;
 
@@ -113,5 +115,7 @@ int main(){
   in_order_linear_dependance();
   event_linear_dependance();
   buffer_in_order_linear_dependance();
+
+  stall_log.print();
   return 0;
 }
\ No newline at end of file
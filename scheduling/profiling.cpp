@@ -0,0 +1,335 @@
+#include <cassert>
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+constexpr int SIZE = 64;
+constexpr double tol = 1.0E-6;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// check random test function
+template<typename Scalar_type, typename Tolerance_type, typename String_type>
+void check_equal(Scalar_type A, Scalar_type B, Tolerance_type tol, String_type name){
+  assert(fabs(A - B) < tol);
+  std::cout << "The " << name << " results are successful!" << std::endl;
+}
+
+// profiling timestamps of one named submission in nanoseconds
+struct kernel_timing{
+  std::string name;
+  uint64_t submit;
+  uint64_t start;
+  uint64_t end;
+};
+
+// queue with enable_profiling that records every submission under a name
+//   - submit to start is the time the command waited in the queue
+//   - start to end is the execution time on the device
+//   - timestamps are read once the events are complete
+class profiled_queue{
+public:
+  profiled_queue(const sycl::device& D, bool in_order = false)
+    : Q{D, in_order ? sycl::property_list{sycl::property::queue::enable_profiling(),
+                                          sycl::property::queue::in_order()}
+                    : sycl::property_list{sycl::property::queue::enable_profiling()}}{}
+
+  template<typename CGF_type>
+  sycl::event submit(const std::string& name, CGF_type cgf){
+    return record(name, Q.submit(cgf));
+  }
+
+  template<typename... Arg_types>
+  sycl::event parallel_for(const std::string& name, Arg_types&&... args){
+    return record(name, Q.parallel_for(std::forward<Arg_types>(args)...));
+  }
+
+  template<typename... Arg_types>
+  sycl::event single_task(const std::string& name, Arg_types&&... args){
+    return record(name, Q.single_task(std::forward<Arg_types>(args)...));
+  }
+
+  sycl::queue& queue(){
+    return Q;
+  }
+
+  void wait(){
+    Q.wait();
+  }
+
+  // timestamps of every recorded submission, waits for them to complete
+  std::vector<kernel_timing> timings(){
+    using namespace sycl::info;
+
+    std::vector<kernel_timing> result;
+    for(auto& [name, e] : events){
+      e.wait();
+      result.push_back({name,
+                        e.get_profiling_info<event_profiling::command_submit>(),
+                        e.get_profiling_info<event_profiling::command_start>(),
+                        e.get_profiling_info<event_profiling::command_end>()});
+    }
+    return result;
+  }
+
+  // forgets the recorded submissions
+  void clear(){
+    events.clear();
+  }
+
+private:
+  sycl::event record(const std::string& name, sycl::event e){
+    events.emplace_back(name, e);
+    return e;
+  }
+
+  sycl::queue Q;
+  std::vector<std::pair<std::string, sycl::event>> events;
+};
+
+// escapes a kernel name for a json string
+std::string json_escape(const std::string& s){
+  std::string out;
+  for(char c : s){
+    if(c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+// writes a chrome trace timeline, open it in chrome://tracing or perfetto
+//   - thread 0 shows the queue wait and thread 1 the execution of a command
+//   - time is relative to the earliest submission
+void export_chrome_trace(const std::vector<kernel_timing>& timings, const std::string& path){
+  uint64_t origin = UINT64_MAX;
+  for(auto& t : timings){
+    origin = std::min(origin, t.submit);
+  }
+
+  std::ofstream out{path};
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+
+  bool first = true;
+  auto emit = [&](const std::string& name, int tid, uint64_t begin, uint64_t end){
+    out << (first ? "" : ",\n")
+        << "{\"name\":\"" << json_escape(name) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+        << ",\"ts\":" << (begin - origin)/1000.0 << ",\"dur\":" << (end - begin)/1000.0 << "}";
+    first = false;
+  };
+
+  for(auto& t : timings){
+    emit(t.name + " (queued)", 0, t.submit, std::max(t.submit, t.start));
+    emit(t.name, 1, t.start, t.end);
+  }
+
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+// prints the queue wait and execution time aggregated per kernel name
+void print_kernel_table(const std::vector<kernel_timing>& timings){
+  struct totals{
+    size_t count = 0;
+    uint64_t wait = 0;
+    uint64_t exec = 0;
+    uint64_t max_exec = 0;
+  };
+
+  std::map<std::string, totals> table;
+  for(auto& t : timings){
+    auto& row = table[t.name];
+    const uint64_t exec = t.end - t.start;
+
+    row.count    += 1;
+    row.wait     += t.start > t.submit ? t.start - t.submit : 0;
+    row.exec     += exec;
+    row.max_exec  = std::max(row.max_exec, exec);
+  }
+
+  std::cout << std::left << std::setw(20) << "kernel" << std::right
+            << std::setw(8)  << "count"
+            << std::setw(16) << "wait (ns)"
+            << std::setw(16) << "exec (ns)"
+            << std::setw(16) << "mean (ns)"
+            << std::setw(16) << "max (ns)" << std::endl;
+
+  for(auto& [name, row] : table){
+    std::cout << std::left << std::setw(20) << name << std::right
+              << std::setw(8)  << row.count
+              << std::setw(16) << row.wait
+              << std::setw(16) << row.exec
+              << std::setw(16) << row.exec/row.count
+              << std::setw(16) << row.max_exec << std::endl;
+  }
+}
+
+// in order y pattern with every kernel profiled
+std::vector<kernel_timing> profiled_in_order_y_pattern(const sycl::device& D){
+  profiled_queue Q{D, true};
+  print_device(Q.queue());
+
+  double *A = sycl::malloc_shared<double>(SIZE, Q.queue());
+  double *B = sycl::malloc_shared<double>(SIZE, Q.queue());
+
+  Q.parallel_for("in_order.init_A", SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] = i;
+  });
+
+  Q.parallel_for("in_order.init_B", SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    B[i] = 2*i;
+  });
+
+  Q.parallel_for("in_order.add", SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] += B[i];
+  });
+
+  Q.single_task("in_order.reduce", [=](){
+    for(int i = 1; i < SIZE; ++i){
+      A[0] += A[i];
+    }
+  });
+
+  Q.wait();
+
+  const double result = (SIZE)*(SIZE-1.0)*1.5;
+
+  check_equal(A[0], result, tol, "Profiled In Order Y Pattern");
+  std::cout << "--------------------------------------" << std::endl;
+
+  sycl::free(A, Q.queue());
+  sycl::free(B, Q.queue());
+
+  return Q.timings();
+}
+
+// events y pattern with every kernel profiled
+std::vector<kernel_timing> profiled_events_y_pattern(const sycl::device& D){
+  profiled_queue Q{D};
+  print_device(Q.queue());
+
+  double *A = sycl::malloc_shared<double>(SIZE, Q.queue());
+  double *B = sycl::malloc_shared<double>(SIZE, Q.queue());
+
+  auto event_1 = Q.parallel_for("events.init_A", SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] = i;
+  });
+
+  auto event_2 = Q.parallel_for("events.init_B", SIZE, [=](sycl::id<1> idx){
+    const int i = idx[0];
+    B[i] = 2*i;
+  });
+
+  auto event_3 = Q.parallel_for("events.add", sycl::range{SIZE}, std::vector{event_1, event_2},
+                                [=](sycl::id<1> idx){
+    const int i = idx[0];
+    A[i] += B[i];
+  });
+
+  Q.single_task("events.reduce", event_3, [=](){
+    for(int i = 1; i < SIZE; ++i){
+      A[0] += A[i];
+    }
+  });
+
+  Q.wait();
+
+  const double result = (SIZE)*(SIZE-1.0)*1.5;
+
+  check_equal(A[0], result, tol, "Profiled Events Y Pattern");
+  std::cout << "--------------------------------------" << std::endl;
+
+  sycl::free(A, Q.queue());
+  sycl::free(B, Q.queue());
+
+  return Q.timings();
+}
+
+// buffers y pattern with every command group profiled
+std::vector<kernel_timing> profiled_buffers_y_pattern(const sycl::device& D){
+  profiled_queue Q{D};
+  print_device(Q.queue());
+
+  sycl::buffer<double> A_buffer{sycl::range{SIZE}};
+  sycl::buffer<double> B_buffer{sycl::range{SIZE}};
+
+  Q.submit("buffers.init_A", [&](sycl::handler &h){
+    sycl::accessor A_access{A_buffer, h, sycl::write_only, sycl::no_init};
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      A_access[i] = i;
+    });
+  });
+
+  Q.submit("buffers.init_B", [&](sycl::handler &h){
+    sycl::accessor B_access{B_buffer, h, sycl::write_only, sycl::no_init};
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      B_access[i] = 2.0*i;
+    });
+  });
+
+  Q.submit("buffers.add", [&](sycl::handler &h){
+    sycl::accessor A_access{A_buffer, h, sycl::read_write};
+    sycl::accessor B_access{B_buffer, h, sycl::read_only};
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      A_access[i] += B_access[i];
+    });
+  });
+
+  Q.submit("buffers.reduce", [&](sycl::handler &h){
+    sycl::accessor A_access{A_buffer, h, sycl::read_write};
+    h.single_task([=](){
+      for(int i = 1; i < SIZE; ++i){
+        A_access[0] += A_access[i];
+      }
+    });
+  });
+
+  Q.wait();
+
+  const double result = (SIZE)*(SIZE-1.0)*1.5;
+
+  sycl::host_accessor A_host{A_buffer, sycl::read_only};
+
+  check_equal(A_host[0], result, tol, "Profiled Buffers Y Pattern");
+  std::cout << "--------------------------------------" << std::endl;
+
+  return Q.timings();
+}
+
+int main(){
+  sycl::device D{sycl::gpu_selector_v};
+
+  std::vector<kernel_timing> timings;
+  for(auto flow : {profiled_in_order_y_pattern, profiled_events_y_pattern,
+                   profiled_buffers_y_pattern}){
+    auto flow_timings = flow(D);
+    timings.insert(timings.end(), flow_timings.begin(), flow_timings.end());
+  }
+
+  print_kernel_table(timings);
+
+  export_chrome_trace(timings, "y_pattern_trace.json");
+  std::cout << "Timeline written to y_pattern_trace.json" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,575 @@
+#include <cassert>
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr int SIZE = 64;
+constexpr double tol = 1.0E-6;
+
+// number of times the graph is submitted
+constexpr int repeats = 10;
+
+// largest number of queues in a queue pool
+constexpr size_t pool_size = 4;
+
+// problem size and chunk size of the host tasks
+constexpr size_t host_size = 1 << 16;
+constexpr size_t grain = 1024;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// check random test function
+template<typename Scalar_type, typename Tolerance_type, typename String_type>
+void check_equal(Scalar_type A, Scalar_type B, Tolerance_type tol, String_type name){
+  assert(fabs(A - B) < tol);
+  std::cout << "The " << name << " results are successful!" << std::endl;
+}
+
+// byte range of a usm allocation touched by a task
+struct usm_range{
+  std::uintptr_t begin;
+  std::uintptr_t end;
+};
+
+template<typename Scalar_type>
+usm_range range_of(const Scalar_type* ptr, size_t count){
+  const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+  return {begin, begin + count*sizeof(Scalar_type)};
+}
+
+bool overlaps(const usm_range& a, const usm_range& b){
+  return a.begin < b.end && b.begin < a.end;
+}
+
+bool overlaps(const std::vector<usm_range>& a, const std::vector<usm_range>& b){
+  for(auto& ra : a){
+    for(auto& rb : b){
+      if(overlaps(ra, rb)) return true;
+    }
+  }
+  return false;
+}
+
+// host thread pool where idle threads steal work from busy ones
+//   - every thread owns a deque, it runs its own tasks from the back and
+//     steals from the front of the other deques
+//   - a thread waiting in parallel_for runs tasks instead of blocking
+class work_stealing_pool{
+public:
+  explicit work_stealing_pool(size_t threads = std::thread::hardware_concurrency())
+    : queues(std::max<size_t>(threads, 1)){
+    for(size_t t = 0; t < queues.size(); ++t){
+      workers.emplace_back([this, t](){ run(t); });
+    }
+  }
+
+  ~work_stealing_pool(){
+    {
+      std::lock_guard<std::mutex> guard{sleep_mtx};
+      stop = true;
+    }
+    wake.notify_all();
+
+    for(auto& worker : workers){
+      worker.join();
+    }
+  }
+
+  work_stealing_pool(const work_stealing_pool&) = delete;
+  work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+  size_t size() const{
+    return queues.size();
+  }
+
+  // adds a task to the deques in round robin order
+  void push(std::function<void()> task){
+    auto& q = queues[next++ % queues.size()];
+    {
+      std::lock_guard<std::mutex> guard{q.mtx};
+      q.tasks.push_back(std::move(task));
+    }
+
+    {
+      std::lock_guard<std::mutex> guard{sleep_mtx};
+      ++pending;
+    }
+    wake.notify_one();
+  }
+
+  // runs f(begin, end) over chunks of [0, n) and returns when all are done
+  template<typename Function_type>
+  void parallel_for(size_t n, size_t chunk, Function_type f){
+    std::atomic<size_t> remaining{(n + chunk - 1)/chunk};
+
+    for(size_t begin = 0; begin < n; begin += chunk){
+      const size_t end = std::min(begin + chunk, n);
+      push([&remaining, f, begin, end](){
+        f(begin, end);
+        --remaining;
+      });
+    }
+
+    while(remaining > 0){
+      if(!try_run(0)) std::this_thread::yield();
+    }
+  }
+
+private:
+  struct task_queue{
+    std::mutex mtx;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // runs one task from the own deque or stolen from another
+  bool try_run(size_t self){
+    std::function<void()> task;
+
+    for(size_t k = 0; k < queues.size() && !task; ++k){
+      auto& q = queues[(self + k) % queues.size()];
+      std::lock_guard<std::mutex> guard{q.mtx};
+
+      if(q.tasks.empty()) continue;
+
+      if(k == 0){
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+      }
+      else{
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+      }
+    }
+
+    if(!task) return false;
+
+    --pending;
+    task();
+    return true;
+  }
+
+  void run(size_t self){
+    while(true){
+      if(try_run(self)) continue;
+
+      std::unique_lock<std::mutex> lock{sleep_mtx};
+      wake.wait(lock, [&](){ return stop || pending > 0; });
+      if(stop && pending == 0) return;
+    }
+  }
+
+  std::vector<task_queue> queues;
+  std::vector<std::thread> workers;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> pending{0};
+  bool stop = false;
+  std::mutex sleep_mtx;
+  std::condition_variable wake;
+};
+
+// usm task graph with event edges inferred from the declared ranges
+//   - a task depends on every earlier task it has a read after write,
+//     write after read or write after write conflict with
+//   - a repeated submission also waits for the conflicting tasks of the
+//     previous submission, so the graph can be resubmitted in a loop
+//   - submitting to a queue pool places each task on the queue where it
+//     can start first, ready tasks on the longest remaining path go first
+//   - host tasks are sycl host_task nodes that hand their work to a host
+//     thread pool, so they take part in the same event dependencies
+class usm_task_graph{
+public:
+  using task_type = std::function<void(sycl::handler&)>;
+
+  // adds a task with a relative cost estimate, returns its index
+  size_t add(const std::string& name, std::vector<usm_range> reads,
+             std::vector<usm_range> writes, task_type task, double cost = 1.0){
+    const size_t k = nodes.size();
+    nodes.push_back({name, std::move(reads), std::move(writes), std::move(task), cost,
+                     {}, {}, {}});
+
+    for(size_t j = 0; j <= k; ++j){
+      if(conflict(nodes[j], nodes[k])){
+        if(j < k){
+          nodes[k].predecessors.push_back(j);
+          nodes[j].successors.push_back(k);
+        }
+        nodes[j].carried.push_back(k);
+      }
+    }
+
+    return k;
+  }
+
+  // adds a host task running work(pool), the pool must outlive the graph
+  size_t add_host(const std::string& name, std::vector<usm_range> reads,
+                  std::vector<usm_range> writes, work_stealing_pool& pool,
+                  std::function<void(work_stealing_pool&)> work, double cost = 1.0){
+    return add(name, std::move(reads), std::move(writes), [&pool, work](sycl::handler &h){
+      h.host_task([&pool, work](){
+        work(pool);
+      });
+    }, cost);
+  }
+
+  // submits every task of the graph once
+  std::vector<sycl::event> submit(sycl::queue& Q){
+    std::vector<sycl::queue> pool{Q};
+    return submit(pool);
+  }
+
+  // submits every task of the graph once over a pool of queues
+  std::vector<sycl::event> submit(std::vector<sycl::queue>& pool){
+    const size_t n = nodes.size();
+
+    // longest remaining path from each task, tasks are stored in a
+    // topological order so successors are visited first
+    std::vector<double> level(n, 0.0);
+    for(size_t i = n; i-- > 0;){
+      for(auto j : nodes[i].successors){
+        level[i] = std::max(level[i], level[j]);
+      }
+      level[i] += nodes[i].cost;
+    }
+
+    std::vector<size_t> remaining(n);
+    std::vector<size_t> ready;
+    for(size_t i = 0; i < n; ++i){
+      remaining[i] = nodes[i].predecessors.size();
+      if(remaining[i] == 0) ready.push_back(i);
+    }
+
+    std::vector<double> finish(n, 0.0);
+    std::vector<double> queue_finish(pool.size(), 0.0);
+    std::vector<sycl::event> events(n);
+    assignment.assign(n, 0);
+
+    while(!ready.empty()){
+      // critical path first
+      auto next = std::max_element(ready.begin(), ready.end(), [&](size_t a, size_t b){
+        return level[a] < level[b];
+      });
+      const size_t i = *next;
+      ready.erase(next);
+
+      double ready_time = 0.0;
+      for(auto j : nodes[i].predecessors){
+        ready_time = std::max(ready_time, finish[j]);
+      }
+
+      // queue where the task can start first
+      size_t q = 0;
+      double start = std::numeric_limits<double>::max();
+      for(size_t c = 0; c < pool.size(); ++c){
+        const double candidate = std::max(queue_finish[c], ready_time);
+        if(candidate < start){
+          start = candidate;
+          q = c;
+        }
+      }
+
+      events[i] = submit_node(pool[q], i, events);
+
+      assignment[i] = q;
+      finish[i] = start + nodes[i].cost;
+      queue_finish[q] = finish[i];
+
+      for(auto j : nodes[i].successors){
+        if(--remaining[j] == 0) ready.push_back(j);
+      }
+    }
+
+    last_events = events;
+    return events;
+  }
+
+  // waits for the last submission
+  void wait(){
+    sycl::event::wait(last_events);
+  }
+
+  // prints the inferred edges and the queue of the last submission
+  void print() const{
+    for(size_t i = 0; i < nodes.size(); ++i){
+      std::cout << nodes[i].name;
+      if(i < assignment.size()){
+        std::cout << " (queue " << assignment[i] << ")";
+      }
+      std::cout << " <-";
+      for(auto j : nodes[i].predecessors){
+        std::cout << " [" << nodes[j].name << "]";
+      }
+      std::cout << std::endl;
+    }
+  }
+
+private:
+  struct node{
+    std::string name;
+    std::vector<usm_range> reads;
+    std::vector<usm_range> writes;
+    task_type task;
+    double cost;
+    std::vector<size_t> predecessors;   // earlier tasks of the same submission
+    std::vector<size_t> successors;     // later tasks of the same submission
+    std::vector<size_t> carried;        // later tasks of the previous submission
+  };
+
+  // submits one task after its predecessors and carried dependencies
+  sycl::event submit_node(sycl::queue& Q, size_t i, const std::vector<sycl::event>& events){
+    std::vector<sycl::event> dependencies;
+
+    for(auto j : nodes[i].predecessors){
+      dependencies.push_back(events[j]);
+    }
+
+    if(!last_events.empty()){
+      for(auto j : nodes[i].carried){
+        dependencies.push_back(last_events[j]);
+      }
+    }
+
+    return Q.submit([&](sycl::handler &h){
+      h.depends_on(dependencies);
+      nodes[i].task(h);
+    });
+  }
+
+  static bool conflict(const node& a, const node& b){
+    return overlaps(a.writes, b.reads) || overlaps(a.writes, b.writes) ||
+           overlaps(a.reads, b.writes);
+  }
+
+  std::vector<node> nodes;
+  std::vector<sycl::event> last_events;
+  std::vector<size_t> assignment;
+};
+
+// at most count in order queues over the sub-devices of a partitionable
+// cpu, or over the device itself, all sharing one context so usm is valid
+// on every queue
+std::vector<sycl::queue> make_queue_pool(const sycl::device& D, size_t count){
+  std::vector<sycl::device> devices;
+
+  if(D.is_cpu() && D.get_info<sycl::info::device::partition_max_sub_devices>() > 1){
+    // compute units per sub-device rounded up so no more than count are made
+    const size_t units = D.get_info<sycl::info::device::max_compute_units>();
+    try{
+      devices = D.create_sub_devices<sycl::info::partition_property::partition_equally>(
+                  std::max<size_t>((units + count - 1)/count, 1));
+    } catch(sycl::exception& e){
+      devices.clear();
+    }
+  }
+
+  std::vector<sycl::queue> pool;
+
+  if(devices.empty()){
+    sycl::context context{D};
+    for(size_t q = 0; q < count; ++q){
+      pool.emplace_back(context, D, sycl::property::queue::in_order());
+    }
+  }
+  else{
+    sycl::context context{devices};
+    for(auto& sub_device : devices){
+      pool.emplace_back(context, sub_device, sycl::property::queue::in_order());
+    }
+  }
+
+  return pool;
+}
+
+// task graph y pattern
+void task_graph_y_pattern(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  double *A = sycl::malloc_shared<double>(SIZE, Q);
+  double *B = sycl::malloc_shared<double>(SIZE, Q);
+
+  usm_task_graph graph;
+
+  graph.add("A = i", {}, {range_of(A, SIZE)}, [=](sycl::handler &h){
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      A[i] = i;
+    });
+  });
+
+  graph.add("B = 2i", {}, {range_of(B, SIZE)}, [=](sycl::handler &h){
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      B[i] = 2*i;
+    });
+  });
+
+  graph.add("A += B", {range_of(A, SIZE), range_of(B, SIZE)}, {range_of(A, SIZE)},
+            [=](sycl::handler &h){
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      A[i] += B[i];
+    });
+  });
+
+  graph.add("sum A", {range_of(A, SIZE)}, {range_of(A, 1)}, [=](sycl::handler &h){
+    h.single_task([=](){
+      for(int i = 1; i < SIZE; ++i){
+        A[0] += A[i];
+      }
+    });
+  });
+
+  graph.print();
+
+  for(int r = 0; r < repeats; ++r){
+    graph.submit(Q);
+  }
+  graph.wait();
+
+  const double result = (SIZE)*(SIZE-1.0)*1.5;
+
+  check_equal(A[0], result, tol, "Task Graph Y Pattern");
+  std::cout << "--------------------------------------" << std::endl;
+
+  sycl::free(A, Q);
+  sycl::free(B, Q);
+}
+
+// task graph y pattern over a queue pool
+void multi_queue_y_pattern(){
+  // establishing a queue pool on the gpu
+  auto pool = make_queue_pool(sycl::device{sycl::gpu_selector_v}, pool_size);
+  print_device(pool[0]);
+  std::cout << "Queue pool size: " << pool.size() << std::endl;
+
+  double *A = sycl::malloc_shared<double>(SIZE, pool[0]);
+  double *B = sycl::malloc_shared<double>(SIZE, pool[0]);
+
+  usm_task_graph graph;
+
+  graph.add("A = i", {}, {range_of(A, SIZE)}, [=](sycl::handler &h){
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      A[i] = i;
+    });
+  });
+
+  graph.add("B = 2i", {}, {range_of(B, SIZE)}, [=](sycl::handler &h){
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      B[i] = 2*i;
+    });
+  });
+
+  graph.add("A += B", {range_of(A, SIZE), range_of(B, SIZE)}, {range_of(A, SIZE)},
+            [=](sycl::handler &h){
+    h.parallel_for(SIZE, [=](sycl::id<1> idx){
+      const int i = idx[0];
+      A[i] += B[i];
+    });
+  });
+
+  // the serial reduction dominates the critical path
+  graph.add("sum A", {range_of(A, SIZE)}, {range_of(A, 1)}, [=](sycl::handler &h){
+    h.single_task([=](){
+      for(int i = 1; i < SIZE; ++i){
+        A[0] += A[i];
+      }
+    });
+  }, SIZE);
+
+  for(int r = 0; r < repeats; ++r){
+    graph.submit(pool);
+  }
+  graph.wait();
+  graph.print();
+
+  const double result = (SIZE)*(SIZE-1.0)*1.5;
+
+  check_equal(A[0], result, tol, "Multi Queue Y Pattern");
+  std::cout << "--------------------------------------" << std::endl;
+
+  sycl::free(A, pool[0]);
+  sycl::free(B, pool[0]);
+}
+
+// host generation and validation around a device kernel in one graph
+void host_task_pipeline(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  work_stealing_pool pool;
+  std::cout << "Host pool threads: " << pool.size() << std::endl;
+
+  double *X = sycl::malloc_shared<double>(host_size, Q);
+  double *Y = sycl::malloc_shared<double>(host_size, Q);
+
+  std::atomic<size_t> mismatches{0};
+
+  usm_task_graph graph;
+
+  graph.add_host("fill X", {}, {range_of(X, host_size)}, pool, [=](work_stealing_pool& p){
+    p.parallel_for(host_size, grain, [=](size_t begin, size_t end){
+      for(size_t i = begin; i < end; ++i){
+        X[i] = i;
+      }
+    });
+  });
+
+  graph.add("Y = 2X", {range_of(X, host_size)}, {range_of(Y, host_size)}, [=](sycl::handler &h){
+    h.parallel_for(host_size, [=](sycl::id<1> idx){
+      const size_t i = idx[0];
+      Y[i] = 2.0*X[i];
+    });
+  });
+
+  graph.add_host("check Y", {range_of(Y, host_size)}, {}, pool, [=, &mismatches](work_stealing_pool& p){
+    p.parallel_for(host_size, grain, [=, &mismatches](size_t begin, size_t end){
+      size_t local = 0;
+      for(size_t i = begin; i < end; ++i){
+        local += fabs(Y[i] - 2.0*i) >= tol;
+      }
+      mismatches += local;
+    });
+  });
+
+  for(int r = 0; r < repeats; ++r){
+    graph.submit(Q);
+  }
+  graph.wait();
+  graph.print();
+
+  check_equal(double(mismatches), 0.0, tol, "Host Task Pipeline");
+  std::cout << "--------------------------------------" << std::endl;
+
+  sycl::free(X, Q);
+  sycl::free(Y, Q);
+}
+
+int main(){
+  task_graph_y_pattern();
+  multi_queue_y_pattern();
+  host_task_pipeline();
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+// hot path telemetry for the memory examples
+//   - compiled in with -DSYCL_TELEMETRY, otherwise the macros are empty
+//     statements and the wrappers are inline forwards to sycl
+//   - counters, byte meters and scoped timers are aggregated per name
+//   - the aggregate is written as csv at exit, to the path in
+//     SYCL_TELEMETRY_CSV or to telemetry.csv
+#include <CL/sycl.hpp>
+#include <cstddef>
+#include <utility>
+
+#ifdef SYCL_TELEMETRY
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#endif
+
+namespace telemetry{
+
+#ifdef SYCL_TELEMETRY
+
+// aggregate of one named metric
+struct metric{
+  unsigned long long count = 0;
+  unsigned long long bytes = 0;
+  unsigned long long ns = 0;
+};
+
+// process wide metric table, flushed to the csv sink at exit
+class registry{
+public:
+  static registry& instance(){
+    static registry r;
+    return r;
+  }
+
+  void record(const char* name, unsigned long long count, unsigned long long bytes,
+              unsigned long long ns){
+    std::lock_guard<std::mutex> guard{mtx};
+    auto& m = metrics[name];
+    m.count += count;
+    m.bytes += bytes;
+    m.ns    += ns;
+  }
+
+  void write_csv(std::ostream& out){
+    std::lock_guard<std::mutex> guard{mtx};
+    out << "name,count,bytes,ns\n";
+    for(auto& [name, m] : metrics){
+      out << name << ',' << m.count << ',' << m.bytes << ',' << m.ns << '\n';
+    }
+  }
+
+  ~registry(){
+    const char* path = std::getenv("SYCL_TELEMETRY_CSV");
+    std::ofstream out{path ? path : "telemetry.csv"};
+    write_csv(out);
+  }
+
+private:
+  registry() = default;
+
+  std::mutex mtx;
+  std::map<std::string, metric> metrics;
+};
+
+// adds the lifetime of the scope to a named metric
+class scoped_timer{
+public:
+  explicit scoped_timer(const char* name)
+    : name{name}, start_time{std::chrono::steady_clock::now()}{}
+
+  ~scoped_timer(){
+    using ns = std::chrono::nanoseconds;
+    auto interval = std::chrono::steady_clock::now() - start_time;
+    registry::instance().record(name, 1, 0, std::chrono::duration_cast<ns>(interval).count());
+  }
+
+  scoped_timer(const scoped_timer&) = delete;
+  scoped_timer& operator=(const scoped_timer&) = delete;
+
+private:
+  const char* name;
+  std::chrono::steady_clock::time_point start_time;
+};
+
+#define TELEMETRY_CONCAT_(a, b) a##b
+#define TELEMETRY_CONCAT(a, b) TELEMETRY_CONCAT_(a, b)
+
+#define TELEMETRY_SCOPE(name) \
+  telemetry::scoped_timer TELEMETRY_CONCAT(telemetry_scope_, __LINE__){name}
+#define TELEMETRY_COUNT(name, n) telemetry::registry::instance().record(name, n, 0, 0)
+#define TELEMETRY_BYTES(name, bytes) telemetry::registry::instance().record(name, 1, bytes, 0)
+
+#else
+
+#define TELEMETRY_SCOPE(name) ((void)0)
+#define TELEMETRY_COUNT(name, n) ((void)0)
+#define TELEMETRY_BYTES(name, bytes) ((void)0)
+
+#endif
+
+// usm allocations metered in bytes
+template<typename Scalar_type, typename Queue_type>
+Scalar_type* malloc_device(size_t count, const Queue_type& Q){
+  TELEMETRY_BYTES("malloc_device", count*sizeof(Scalar_type));
+  return sycl::malloc_device<Scalar_type>(count, Q);
+}
+
+template<typename Scalar_type, typename Queue_type>
+Scalar_type* malloc_host(size_t count, const Queue_type& Q){
+  TELEMETRY_BYTES("malloc_host", count*sizeof(Scalar_type));
+  return sycl::malloc_host<Scalar_type>(count, Q);
+}
+
+template<typename Scalar_type, typename Queue_type>
+Scalar_type* malloc_shared(size_t count, const Queue_type& Q){
+  TELEMETRY_BYTES("malloc_shared", count*sizeof(Scalar_type));
+  return sycl::malloc_shared<Scalar_type>(count, Q);
+}
+
+inline void* malloc_shared(size_t bytes, const sycl::queue& Q){
+  TELEMETRY_BYTES("malloc_shared", bytes);
+  return sycl::malloc_shared(bytes, Q);
+}
+
+template<typename Queue_type>
+void free(void* ptr, const Queue_type& Q){
+  TELEMETRY_COUNT("free", 1);
+  sycl::free(ptr, Q);
+}
+
+// memcpy on a queue or inside a command group, metered in bytes
+template<typename Target_type, typename... Arg_types>
+decltype(auto) memcpy(Target_type& target, void* dst, const void* src, size_t bytes,
+                      Arg_types&&... dependencies){
+  TELEMETRY_BYTES("memcpy", bytes);
+  return target.memcpy(dst, src, bytes, std::forward<Arg_types>(dependencies)...);
+}
+
+// prefetch of shared memory, metered in bytes
+template<typename Queue_type, typename... Arg_types>
+sycl::event prefetch(Queue_type& Q, const void* ptr, size_t bytes, Arg_types&&... dependencies){
+  TELEMETRY_BYTES("prefetch", bytes);
+  return Q.prefetch(ptr, bytes, std::forward<Arg_types>(dependencies)...);
+}
+
+// submissions timed on the host, the time to enqueue and not to execute
+template<typename Queue_type, typename CGF_type>
+sycl::event submit(Queue_type& Q, CGF_type&& cgf){
+  TELEMETRY_SCOPE("submit");
+  return Q.submit(std::forward<CGF_type>(cgf));
+}
+
+template<typename Queue_type, typename... Arg_types>
+sycl::event parallel_for(Queue_type& Q, Arg_types&&... args){
+  TELEMETRY_SCOPE("parallel_for");
+  return Q.parallel_for(std::forward<Arg_types>(args)...);
+}
+
+template<typename Queue_type, typename... Arg_types>
+sycl::event single_task(Queue_type& Q, Arg_types&&... args){
+  TELEMETRY_SCOPE("single_task");
+  return Q.single_task(std::forward<Arg_types>(args)...);
+}
+
+} // namespace telemetry
@@ -1,4 +1,7 @@
 #include <CL/sycl.hpp>
+
+#include "../telemetry/telemetry.hpp"
+
 constexpr int SIZE = 256;
 
 // prints device name
@@ -17,18 +20,18 @@ int main(){
   print_device(Q);
 
   // C style memory allocation
-  double *A = static_cast<double*>(sycl::malloc_shared(SIZE*sizeof(double), Q));
+  double *A = static_cast<double*>(telemetry::malloc_shared(SIZE*sizeof(double), Q));
 
   // C++ style memory allocation
-  double *B = sycl::malloc_shared<double>(SIZE, Q);
+  double *B = telemetry::malloc_shared<double>(SIZE, Q);
 
   // C++ allocator
   sycl::usm_allocator<double, sycl::usm::alloc::shared> alloc(Q);
   double *C = alloc.allocate(SIZE);
 
   // deallocate memory
-  sycl::free(A, Q.get_context());
-  sycl::free(B, Q);
+  telemetry::free(A, Q.get_context());
+  telemetry::free(B, Q);
   alloc.deallocate(C, SIZE);
 
   return 0;
@@ -2,6 +2,8 @@
 #include <array>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+
 constexpr int SIZE = 256;
 constexpr double tol = 1.0E-6;
 
@@ -19,7 +21,7 @@ void print_device(Queue_type& Q){
 template<typename Queue_type>
 void explicit_data_movement(Queue_type Q){
   std::array<double, SIZE> A_host;
-  double* A_device = sycl::malloc_device<double>(SIZE, Q);
+  double* A_device = telemetry::malloc_device<double>(SIZE, Q);
 
   // filling up the host array
   for(int i = 0; i < SIZE; ++i){
@@ -27,14 +29,14 @@ void explicit_data_movement(Queue_type Q){
   }
 
   // moving host to device memory
-  Q.submit([&](sycl::handler& h){
-    h.memcpy(A_device, &A_host[0], SIZE*sizeof(double));
+  telemetry::submit(Q, [&](sycl::handler& h){
+    telemetry::memcpy(h, A_device, &A_host[0], SIZE*sizeof(double));
   });
 
   Q.wait();
 
   // task
-  Q.submit([&](sycl::handler& h){
+  telemetry::submit(Q, [&](sycl::handler& h){
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
       const auto i = idx[0];
       A_device[i] = A_device[i]*i;
@@ -44,8 +46,8 @@ void explicit_data_movement(Queue_type Q){
   Q.wait();
 
   // moving device to host memory
-  Q.submit([&](sycl::handler& h){
-    h.memcpy(&A_host[0], A_device, SIZE*sizeof(double));
+  telemetry::submit(Q, [&](sycl::handler& h){
+    telemetry::memcpy(h, &A_host[0], A_device, SIZE*sizeof(double));
   });
 
   Q.wait();
@@ -57,14 +59,14 @@ void explicit_data_movement(Queue_type Q){
 
   std::cout << "The explicit data movement was successful!" << std::endl;
 
-  sycl::free(A_device, Q);
+  telemetry::free(A_device, Q);
 }
 
 // implicit usm data movement
 template<typename Queue_type>
 void implicit_data_movement(Queue_type Q){
-  double* A_host   = sycl::malloc_host<double>(SIZE, Q);
-  double* A_shared = sycl::malloc_shared<double>(SIZE, Q);
+  double* A_host   = telemetry::malloc_host<double>(SIZE, Q);
+  double* A_shared = telemetry::malloc_shared<double>(SIZE, Q);
 
   // filling up the host array
   for(int i = 0; i < SIZE; ++i){
@@ -72,7 +74,7 @@ void implicit_data_movement(Queue_type Q){
   }
 
   // task
-  Q.submit([&](sycl::handler& h){
+  telemetry::submit(Q, [&](sycl::handler& h){
     h.parallel_for(SIZE, [=](sycl::id<1> idx){
       const auto i = idx[0];
       A_shared[i] = A_host[i]*i;
@@ -89,8 +91,8 @@ void implicit_data_movement(Queue_type Q){
   std::cout << "The implicit data movement was successful!" << std::endl;
 
   // free memory
-  sycl::free(A_host, Q);
-  sycl::free(A_shared, Q);
+  telemetry::free(A_host, Q);
+  telemetry::free(A_shared, Q);
 }
 
 int main(){
@@ -1,7 +1,14 @@
 #include <CL/sycl.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include <assert.h>
 
+#include "../telemetry/telemetry.hpp"
+
 // number of threads per block
 constexpr int number_of_threads = 64;
 
@@ -14,6 +21,22 @@ constexpr int SIZE = number_of_threads*number_of_blocks;
 // result tolerance
 constexpr double tol = 1.0E-6;
 
+// number of chunks prefetched ahead of the running kernel
+constexpr int prefetch_depth = 4;
+
+// largest tolerated fraction of launch overhead to kernel work
+constexpr double launch_overhead_ratio = 0.1;
+
+// number of timed runs per benchmark case
+constexpr int attempts = 10;
+
+// portable usm memory advice
+enum class usm_advice{
+  read_mostly,          // replicate instead of migrating on read
+  preferred_location,   // keep the pages resident on the queue device
+  accessed_by           // map the pages for direct access by the queue device
+};
+
 // prints device name
 template<typename Queue_type>
 void print_device(Queue_type& Q){
@@ -24,11 +47,41 @@ void print_device(Queue_type& Q){
             << "\n" << std::endl;
 }
 
+// maps a portable advice onto the backend specific advice value
+//   - values follow ur_usm_advice_flags_t used by the level zero, cuda and
+//     hip backends, other backends have no advice and return false
+template<typename Queue_type>
+bool backend_advice(Queue_type& Q, usm_advice advice, int& value){
+  switch(Q.get_backend()){
+    case sycl::backend::ext_oneapi_level_zero:
+    case sycl::backend::ext_oneapi_cuda:
+    case sycl::backend::ext_oneapi_hip:
+      switch(advice){
+        case usm_advice::read_mostly:        value = 1 << 0; return true;
+        case usm_advice::preferred_location: value = 1 << 2; return true;
+        case usm_advice::accessed_by:        value = 1 << 8; return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+// applies a portable advice to a usm range, returns false when it is a no-op
+template<typename Queue_type>
+bool apply_mem_advice(Queue_type& Q, void* ptr, size_t bytes, usm_advice advice){
+  int value = 0;
+  if(!backend_advice(Q, advice, value)) return false;
+
+  Q.mem_advise(ptr, bytes, value).wait();
+  return true;
+}
+
 // example case using prefetch
 template<typename Queue_type>
 void example_prefetch_case(Queue_type Q){
-  double *A_shared = sycl::malloc_shared<double>(SIZE, Q);
-  double *A_read_only = sycl::malloc_shared<double>(number_of_threads, Q);
+  double *A_shared = telemetry::malloc_shared<double>(SIZE, Q);
+  double *A_read_only = telemetry::malloc_shared<double>(number_of_threads, Q);
 
   // initializing data
   for(int i = 0; i < number_of_threads; ++i){
@@ -36,18 +89,20 @@ void example_prefetch_case(Queue_type Q){
   }
 
   // marking shared data as read only (copies instead of migrate)
-  int hw_specific_advice = 0;
-  Q.mem_advise(A_read_only, number_of_threads, hw_specific_advice);
-  auto e = Q.prefetch(A_shared, number_of_threads);
+  const bool advised = apply_mem_advice(Q, A_read_only, number_of_threads*sizeof(double),
+                                        usm_advice::read_mostly);
+  std::cout << "Read mostly advice: " << (advised ? "applied" : "not supported") << std::endl;
+
+  auto e = telemetry::prefetch(Q, A_shared, number_of_threads);
 
   for(int b = 0; b < number_of_blocks; ++b){
-    Q.parallel_for(sycl::range{number_of_threads}, e, [=](sycl::id<1> idx){
+    telemetry::parallel_for(Q, sycl::range{number_of_threads}, e, [=](sycl::id<1> idx){
       const int i = idx[0];
       A_shared[b*number_of_threads + i] += A_read_only[i];
     });
 
     if((b + 1) < number_of_blocks){
-      e = Q.prefetch(A_shared + (b + 1)*number_of_threads, number_of_threads);
+      e = telemetry::prefetch(Q, A_shared + (b + 1)*number_of_threads, number_of_threads);
     }
   }
   Q.wait();
@@ -61,10 +116,195 @@ void example_prefetch_case(Queue_type Q){
   std::cout << "Prefetching was Successful!" << std::endl;
 }
 
+// measures the minimum host observed cost of an empty kernel launch in ns
+template<typename Queue_type>
+double measure_launch_overhead(Queue_type& Q, int attempts = 20){
+  using ns = std::chrono::nanoseconds;
+  ns::rep min_time = std::numeric_limits<ns::rep>::max();
+
+  // warming up the runtime
+  telemetry::single_task(Q, [=](){}).wait();
+
+  for(int i = 0; i < attempts; ++i){
+    auto start_time = std::chrono::steady_clock::now();
+    telemetry::single_task(Q, [=](){}).wait();
+    auto interval = std::chrono::steady_clock::now() - start_time;
+
+    min_time = std::min(std::chrono::duration_cast<ns>(interval).count(), min_time);
+  }
+
+  return static_cast<double>(min_time);
+}
+
+// streams a shared allocation through a kernel chunk by chunk
+//   - chunks are prefetched depth chunks ahead on a separate queue
+//   - neighbouring chunks are merged into one launch until the launch
+//     overhead is a small fraction of the work done by that launch
+//   - kernel(A, i) is applied to every element i of the allocation
+template<typename Queue_type, typename Scalar_type, typename Kernel_type>
+void stream_shared_chunks(Queue_type& Q, Queue_type& Q_prefetch, Scalar_type* A,
+                          size_t chunk_size, size_t number_of_chunks,
+                          size_t depth, Kernel_type kernel){
+  using ns = std::chrono::nanoseconds;
+
+  if(number_of_chunks == 0) return;
+
+  // prefetch events for each chunk
+  std::vector<sycl::event> prefetched(number_of_chunks);
+  size_t next_prefetch = 0;
+
+  auto prefetch_until = [&](size_t last_chunk){
+    last_chunk = std::min(last_chunk, number_of_chunks);
+    for(; next_prefetch < last_chunk; ++next_prefetch){
+      prefetched[next_prefetch] = telemetry::prefetch(Q_prefetch, A + next_prefetch*chunk_size,
+                                                      chunk_size*sizeof(Scalar_type));
+    }
+  };
+
+  // launches a kernel over count chunks starting at first
+  auto launch = [&](size_t first, size_t count){
+    prefetch_until(first + count + depth);
+
+    std::vector<sycl::event> dependencies(prefetched.begin() + first,
+                                          prefetched.begin() + first + count);
+    const size_t offset = first*chunk_size;
+
+    return telemetry::parallel_for(Q, sycl::range{count*chunk_size}, dependencies, [=](sycl::id<1> idx){
+      kernel(A, offset + idx[0]);
+    });
+  };
+
+  // the first chunk warms up the kernel, its time includes the jit
+  // compilation and the wait for its prefetch
+  launch(0, 1).wait();
+  if(number_of_chunks == 1) return;
+
+  // calibrating the merge factor on the second chunk, prefetched beforehand
+  const double overhead = measure_launch_overhead(Q);
+  prefetch_until(2);
+  prefetched[1].wait();
+
+  auto start_time = std::chrono::steady_clock::now();
+  launch(1, 1).wait();
+  auto interval = std::chrono::steady_clock::now() - start_time;
+
+  const double chunk_time = std::chrono::duration_cast<ns>(interval).count();
+  const double chunk_work = std::max(chunk_time - overhead, 1.0);
+
+  size_t chunks_per_launch = std::ceil(overhead/(launch_overhead_ratio*chunk_work));
+  chunks_per_launch = std::clamp<size_t>(chunks_per_launch, 1, number_of_chunks);
+
+  // streaming the remaining chunks
+  for(size_t c = 2; c < number_of_chunks; c += chunks_per_launch){
+    launch(c, std::min(chunks_per_launch, number_of_chunks - c));
+  }
+  Q.wait();
+
+  std::cout << "Streamed " << number_of_chunks << " chunks with "
+            << chunks_per_launch << " chunks per launch" << std::endl;
+}
+
+// example case using the chunk streaming helper
+template<typename Queue_type>
+void example_streamed_prefetch_case(Queue_type Q){
+  double *A_shared = telemetry::malloc_shared<double>(SIZE, Q);
+  double *A_read_only = telemetry::malloc_shared<double>(number_of_threads, Q);
+
+  // initializing data
+  for(int i = 0; i < SIZE; ++i){
+    A_shared[i] = 0.0;
+  }
+
+  for(int i = 0; i < number_of_threads; ++i){
+    A_read_only[i] = i;
+  }
+
+  apply_mem_advice(Q, A_read_only, number_of_threads*sizeof(double), usm_advice::read_mostly);
+
+  // prefetch queue sharing the context of the compute queue
+  sycl::queue Q_prefetch{Q.get_context(), Q.get_device()};
+
+  stream_shared_chunks(Q, Q_prefetch, A_shared, number_of_threads, number_of_blocks,
+                       prefetch_depth, [=](double* A, size_t i){
+    A[i] += A_read_only[i % number_of_threads];
+  });
+
+  for(int i = 0; i < number_of_blocks; ++i){
+    for(int j = 0; j < number_of_threads; ++j){
+      assert(fabs(A_shared[i*number_of_threads + j] - j) < tol);
+    }
+  }
+
+  std::cout << "Streamed prefetching was Successful!" << std::endl;
+
+  telemetry::free(A_shared, Q);
+  telemetry::free(A_read_only, Q);
+}
+
+// shared usm throughput of a lookup table kernel with and without advice
+template<typename Queue_type>
+void advice_benchmark(Queue_type Q){
+  using ns = std::chrono::nanoseconds;
+
+  double *A_shared = telemetry::malloc_shared<double>(SIZE, Q);
+  double *A_read_only = telemetry::malloc_shared<double>(number_of_threads, Q);
+
+  for(int i = 0; i < SIZE; ++i){
+    A_shared[i] = 0.0;
+  }
+
+  for(int i = 0; i < number_of_threads; ++i){
+    A_read_only[i] = i;
+  }
+
+  // the host reads the table between launches, which migrates it back
+  // and forth unless the read mostly advice replicates it
+  auto time_case = [&](){
+    ns::rep min_time = std::numeric_limits<ns::rep>::max();
+    double host_sum = 0.0;
+
+    for(int a = 0; a < attempts; ++a){
+      auto start_time = std::chrono::steady_clock::now();
+
+      telemetry::parallel_for(Q, SIZE, [=](sycl::id<1> idx){
+        const int i = idx[0];
+        A_shared[i] += A_read_only[i % number_of_threads];
+      }).wait();
+
+      for(int i = 0; i < number_of_threads; ++i){
+        host_sum += A_read_only[i];
+      }
+
+      auto interval = std::chrono::steady_clock::now() - start_time;
+      min_time = std::min(std::chrono::duration_cast<ns>(interval).count(), min_time);
+    }
+
+    assert(host_sum > 0.0);
+    return static_cast<double>(min_time);
+  };
+
+  const double bytes = (2.0*SIZE + number_of_threads)*sizeof(double);
+
+  const double time_without = time_case();
+
+  const bool advised = apply_mem_advice(Q, A_read_only, number_of_threads*sizeof(double),
+                                        usm_advice::read_mostly);
+  const double time_with = time_case();
+
+  std::cout << "Without advice: " << bytes/time_without << " GB/s\n"
+            << "With advice:    " << bytes/time_with << " GB/s"
+            << (advised ? "" : " (advice not supported, no-op)") << std::endl;
+
+  telemetry::free(A_shared, Q);
+  telemetry::free(A_read_only, Q);
+}
+
 int main(){
   // establishing gpu for device queue
   sycl::queue Q{sycl::gpu_selector_v};
   print_device(Q);
 
   example_prefetch_case(Q);
+  example_streamed_prefetch_case(Q);
+  advice_benchmark(Q);
 }
\ No newline at end of file
@@ -1,10 +1,37 @@
 #include <CL/sycl.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "../telemetry/telemetry.hpp"
 
 namespace dinfo = sycl::info::device;
 
 constexpr int SIZE = 64;
 constexpr double tol = 1.0E-6;
 
+// number of timed runs per backend
+constexpr int attempts = 5;
+
+// memory backends a kernel can run on
+enum class memory_backend{
+  buffer,
+  device_usm,
+  shared_usm
+};
+
+// memory backend name
+const char* backend_name(memory_backend backend){
+  switch(backend){
+    case memory_backend::buffer:     return "Buffer";
+    case memory_backend::device_usm: return "Device USM";
+    case memory_backend::shared_usm: return "Shared USM";
+  }
+  return "Unknown";
+}
+
 // prints device name
 template<typename Queue_type>
 void print_device(Queue_type& Q){
@@ -45,10 +72,10 @@ void usm_querries(Queue_type Q){
   if(use_usm){
     double *A;
     if(usm_shared){
-      A = sycl::malloc_shared<double>(SIZE, Q);
+      A = telemetry::malloc_shared<double>(SIZE, Q);
     }
     else{
-      A = sycl::malloc_device<double>(SIZE, Q);
+      A = telemetry::malloc_device<double>(SIZE, Q);
     }
 
     std::cout << "USM: " << ((sycl::get_pointer_type(A, context) == sycl::usm::alloc::shared)
@@ -56,7 +83,7 @@ void usm_querries(Queue_type Q){
                          << sycl::get_pointer_device(A, context).template get_info<dinfo::name>()
                          << std::endl;
 
-    Q.parallel_for(SIZE, [=](sycl::id<1> idx){
+    telemetry::parallel_for(Q, SIZE, [=](sycl::id<1> idx){
       const int i = idx[0];
       equal_to_size(A, i);
     });
@@ -64,11 +91,11 @@ void usm_querries(Queue_type Q){
 
     check_equal_to_size(A);
 
-    sycl::free(A, Q);
+    telemetry::free(A, Q);
   }
   else{
     sycl::buffer<double, 1> A{sycl::range{SIZE}};
-    Q.submit([&](sycl::handler &h){
+    telemetry::submit(Q, [&](sycl::handler &h){
       sycl::accessor acc(A, h);
       h.parallel_for(SIZE, [=](sycl::id<1> idx){
         const int i = idx[0];
@@ -84,12 +111,126 @@ void usm_querries(Queue_type Q){
   std::cout << "Results are Successful!" << std::endl;
 }
 
+// runs an access pattern over host data with the given memory backend
+//   - pattern(A, i) is called for every index with an accessor or pointer
+//   - the timing includes allocation and the host/device data movement
+template<typename Queue_type, typename Pattern_type>
+void run_on_backend(Queue_type& Q, memory_backend backend, Pattern_type pattern,
+                    std::vector<double>& A_host){
+  const size_t n = A_host.size();
+
+  switch(backend){
+    case memory_backend::buffer:{
+      // results are written back when the buffer is destroyed
+      sycl::buffer<double, 1> A{A_host.data(), sycl::range{n}};
+      telemetry::submit(Q, [&](sycl::handler &h){
+        sycl::accessor acc(A, h);
+        h.parallel_for(n, [=](sycl::id<1> idx){
+          pattern(acc, idx[0]);
+        });
+      });
+      break;
+    }
+    case memory_backend::device_usm:{
+      double *A = telemetry::malloc_device<double>(n, Q);
+      telemetry::memcpy(Q, A, A_host.data(), n*sizeof(double)).wait();
+      telemetry::parallel_for(Q, n, [=](sycl::id<1> idx){
+        pattern(A, idx[0]);
+      }).wait();
+      telemetry::memcpy(Q, A_host.data(), A, n*sizeof(double)).wait();
+      telemetry::free(A, Q);
+      break;
+    }
+    case memory_backend::shared_usm:{
+      double *A = telemetry::malloc_shared<double>(n, Q);
+      std::copy(A_host.begin(), A_host.end(), A);
+      telemetry::parallel_for(Q, n, [=](sycl::id<1> idx){
+        pattern(A, idx[0]);
+      }).wait();
+      std::copy(A, A + n, A_host.begin());
+      telemetry::free(A, Q);
+      break;
+    }
+  }
+}
+
+// probes the device and benchmarks the supported backends for a pattern
+template<typename Queue_type, typename Pattern_type>
+memory_backend select_memory_backend(Queue_type& Q, Pattern_type pattern, size_t n){
+  using ns = std::chrono::nanoseconds;
+
+  auto device = Q.get_device();
+
+  // buffers are always supported
+  std::vector<memory_backend> candidates{memory_backend::buffer};
+
+  if(device.template get_info<dinfo::usm_device_allocations>()){
+    candidates.push_back(memory_backend::device_usm);
+  }
+
+  if(device.template get_info<dinfo::usm_shared_allocations>()){
+    candidates.push_back(memory_backend::shared_usm);
+  }
+
+  std::vector<double> A_host(n, 0.0);
+
+  memory_backend best = memory_backend::buffer;
+  ns::rep best_time = std::numeric_limits<ns::rep>::max();
+
+  for(auto backend : candidates){
+    // warming up the backend
+    run_on_backend(Q, backend, pattern, A_host);
+
+    ns::rep min_time = std::numeric_limits<ns::rep>::max();
+
+    for(int a = 0; a < attempts; ++a){
+      auto start_time = std::chrono::steady_clock::now();
+      run_on_backend(Q, backend, pattern, A_host);
+      auto interval = std::chrono::steady_clock::now() - start_time;
+
+      min_time = std::min(std::chrono::duration_cast<ns>(interval).count(), min_time);
+    }
+
+    std::cout << backend_name(backend) << ": " << min_time << " ns" << std::endl;
+
+    if(min_time < best_time){
+      best_time = min_time;
+      best = backend;
+    }
+  }
+
+  return best;
+}
+
+// selects the fastest memory backend and uses it for the computation
+template<typename Queue_type>
+void adaptive_usm_querries(Queue_type Q){
+  auto pattern = [=](auto A, auto i){
+    equal_to_size(A, i);
+  };
+
+  std::cout << "PLATFORM: "
+            << Q.get_device().get_platform().template get_info<sycl::info::platform::name>()
+            << std::endl;
+
+  const memory_backend backend = select_memory_backend(Q, pattern, SIZE);
+  std::cout << "Selected Backend: " << backend_name(backend) << std::endl;
+
+  std::vector<double> A_host(SIZE, 0.0);
+  run_on_backend(Q, backend, pattern, A_host);
+
+  check_equal_to_size(A_host);
+
+  std::cout << "Adaptive Results are Successful!" << std::endl;
+}
+
 int main(){
   // establishing gpu for device queue
   sycl::queue Q{sycl::gpu_selector_v};
   print_device(Q);
 
   usm_querries(Q);
+  adaptive_usm_querries(Q);
 
   return 0;
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+// launch configurations picked from device and kernel limits instead of
+// fixed work group sizes
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+// largest work group size a kernel can be launched with on the queue device,
+// builds the kernel so query it once per launch
+template<typename Kernel_name, typename Queue_type>
+size_t kernel_work_group_limit(Queue_type& Q){
+  const auto id = sycl::get_kernel_id<Kernel_name>();
+  auto bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(Q.get_context(),
+                                                                        {Q.get_device()}, {id});
+  return bundle.get_kernel(id).template get_info<sycl::info::kernel_device_specific::work_group_size>(Q.get_device());
+}
+
+// largest power of two local size dividing global, at most preferred, that
+// fits the kernel work group limit and local_bytes_per_item of local memory
+// per work item
+template<typename Queue_type>
+size_t pick_local_size(Queue_type& Q, size_t kernel_limit, size_t global, size_t preferred,
+                       size_t local_bytes_per_item = 0){
+  size_t limit = std::min(preferred, kernel_limit);
+  if(local_bytes_per_item > 0){
+    limit = std::min<size_t>(limit, Q.get_device().template get_info<sycl::info::device::local_mem_size>()/local_bytes_per_item);
+  }
+
+  size_t local = 1;
+  while(2*local <= limit && global%(2*local) == 0){
+    local *= 2;
+  }
+  return local;
+}
+
+// checks a launch configuration against the device and kernel limits
+template<typename Queue_type>
+void validate_launch(Queue_type& Q, size_t kernel_limit, size_t global, size_t local,
+                     size_t local_bytes){
+  if(local == 0 || global%local != 0){
+    throw std::invalid_argument("The local size must divide the global size");
+  }
+
+  if(local > kernel_limit){
+    throw std::invalid_argument("The local size exceeds the kernel work group limit");
+  }
+
+  if(local_bytes > Q.get_device().template get_info<sycl::info::device::local_mem_size>()){
+    throw std::invalid_argument("The local memory exceeds the device local memory");
+  }
+}
+
+// largest power of two b, at most preferred, whose b x b work group divides
+// both global dimensions and fits the kernel work group limit
+template<typename Queue_type>
+size_t pick_square_local_size(Queue_type& Q, size_t kernel_limit, size_t rows, size_t cols,
+                              size_t preferred){
+  const size_t limit = std::min<size_t>(kernel_limit,
+                                        Q.get_device().template get_info<sycl::info::device::max_work_group_size>());
+
+  size_t b = 1;
+  while(2*b <= preferred && 4*b*b <= limit && rows%(2*b) == 0 && cols%(2*b) == 0){
+    b *= 2;
+  }
+  return b;
+}
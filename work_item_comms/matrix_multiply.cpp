@@ -5,6 +5,12 @@
 #include <assert.h>
 #include <random>
 #include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "../common_errors/checked_view.hpp"
+#include "../common_parallel_functions/host_matrix_multiply.hpp"
+#include "launch_config.hpp"
 
 extern const size_t M = 256;
 extern const size_t N = 128;
@@ -17,6 +23,12 @@ static const int attempts = 10;
 // matrix multiplication selection type
 static const int selection = 1;
 
+// validation type, 0 checks every entry and 1 checks a random sample
+static const int validation = 0;
+
+// number of sampled entries
+static const size_t samples = 1024;
+
 // prints device name
 template<typename Queue_type>
 void print_device(Queue_type& Q){
@@ -29,18 +41,24 @@ void print_device(Queue_type& Q){
 
 // verifying matrix multiply results
 template<typename Scalar_type>
-void check_matrix_multiply(std::vector<Scalar_type> A,
-                           std::vector<Scalar_type> B,
-                           std::vector<Scalar_type> C,
+void check_matrix_multiply(const std::vector<Scalar_type>& A,
+                           const std::vector<Scalar_type>& B,
+                           const std::vector<Scalar_type>& C,
                            Scalar_type tol){
+  if constexpr (validation == 1){
+    sample_check_matrix_multiply(A.data(), B.data(), C.data(), M, N, K, samples, tol);
+    std::cout << "The matrix multiply results are correct!" << std::endl;
+    return;
+  }
+
+  // host reference result
+  std::vector<Scalar_type> C_reference(M*N);
+  host_matrix_multiply(A.data(), B.data(), C_reference.data(), M, N, K);
+
   // confirming results
   for(int i = 0; i < M; ++i){
     for(int j = 0; j < N; ++j){
-      double c_ij = 0.0;
-      for(int k = 0; k < K; ++k){
-        c_ij += A[i*K + k]*B[k*N + j];
-      }
-      assert(std::fabs(C[i*N + j] - c_ij) < tol);
+      assert(std::fabs(C[i*N + j] - C_reference[i*N + j]) < tol);
     }
   }
 
@@ -78,7 +96,14 @@ void basic_matrix_multiply(Queue_type Q, std::vector<Scalar_type>& A,
   Q.wait();
 }
 
+// kernel name of the tiled matrix multiply
+template<typename Scalar_type>
+class tiled_matrix_multiply_kernel;
+
 // ndrange tiled matrix multiply
+//   - tile_size is the preferred tile, the tile actually used divides N and K
+//     and fits the kernel work group and the device local memory limits
+//   - indexing goes through checked views, bounds checked unless NDEBUG
 template<typename Queue_type, typename Scalar_type>
 void ndrange_tiled_matrix_multiply(Queue_type Q, std::vector<Scalar_type>& A,
                                                  std::vector<Scalar_type>& B,
@@ -87,15 +112,25 @@ void ndrange_tiled_matrix_multiply(Queue_type Q, std::vector<Scalar_type>& A,
   sycl::buffer<Scalar_type, 2> B_buffer{B.data(), sycl::range<2>{K, N}};
   sycl::buffer<Scalar_type, 2> C_buffer{C.data(), sycl::range<2>{M, N}};
 
+  using kernel_name = tiled_matrix_multiply_kernel<Scalar_type>;
+
+  const size_t limit = kernel_work_group_limit<kernel_name>(Q);
+  const size_t tile  = pick_local_size(Q, limit, std::gcd(N, K), tile_size, sizeof(Scalar_type));
+  validate_launch(Q, limit, N, tile, tile*sizeof(Scalar_type));
+
+  bounds_log bounds;
+
   Q.submit([&](sycl::handler& h){
-    sycl::accessor A_access{A_buffer, h, sycl::read_only};
-    sycl::accessor B_access{B_buffer, h, sycl::read_only};
-    sycl::accessor C_access{C_buffer, h, sycl::read_write};
+    auto record = bounds.device_record(h);
+
+    checked_view A_access{sycl::accessor{A_buffer, h, sycl::read_only}, record};
+    checked_view B_access{sycl::accessor{B_buffer, h, sycl::read_only}, record};
+    checked_view C_access{sycl::accessor{C_buffer, h, sycl::read_write}, record};
 
     // matrix tile local access
-    auto tile_access = sycl::local_accessor<Scalar_type, 1>(tile_size, h);
+    checked_view tile_access{sycl::local_accessor<Scalar_type, 1>(tile, h), record};
 
-    h.parallel_for(sycl::nd_range<2>{{M, N}, {1, tile_size}}, [=](sycl::nd_item<2> it){
+    h.parallel_for<kernel_name>(sycl::nd_range<2>{{M, N}, {1, tile}}, [=](sycl::nd_item<2> it){
       const int i = it.get_global_id()[0];
       const int j = it.get_global_id()[1];
 
@@ -103,23 +138,25 @@ void ndrange_tiled_matrix_multiply(Queue_type Q, std::vector<Scalar_type>& A,
 
       Scalar_type c_ij = 0;
 
-      for(int kk = 0; kk < K; kk += tile_size){
-        tile_access[x] = A_access[i][kk + x];
+      for(int kk = 0; kk < K; kk += tile){
+        tile_access(x) = A_access(i, kk + x);
 
         sycl::group_barrier(it.get_group());
 
-        for(int k = 0; k < tile_size; ++k){
-          c_ij += tile_access[k] * B_access[kk + k][j];
+        for(int k = 0; k < tile; ++k){
+          c_ij += tile_access(k) * B_access(kk + k, j);
         }
 
         sycl::group_barrier(it.get_group());
       }
 
-      C_access[i][j] = c_ij;
+      C_access(i, j) = c_ij;
     });
   });
 
   Q.wait();
+
+  bounds.report("ndrange_tiled_matrix_multiply");
 }
 
 // benchmark time
@@ -3,6 +3,8 @@
 #include <assert.h>
 #include <iostream>
 
+#include "launch_config.hpp"
+
 // prints device name
 template<typename Queue_type>
 void print_device(Queue_type& Q){
@@ -22,20 +24,28 @@ void validate_plus_one(Array_type A, Int_type SIZE){
   std::cout << "The results are correct!" << std::endl;
 }
 
+// kernel name of the local accessor example
+class local_accessors_kernel;
+
 // investigating local accessors
 template<typename Queue_type, typename Array_type, typename Int_type>
 void local_accessors(Queue_type Q, Array_type& A, Int_type SIZE){
   // data buffer
   sycl::buffer A_buffer{A};
 
+  // work group size from the device and kernel limits
+  const size_t limit = kernel_work_group_limit<local_accessors_kernel>(Q);
+  const size_t local = pick_local_size(Q, limit, SIZE, SIZE, sizeof(double));
+  validate_launch(Q, limit, SIZE, local, local*sizeof(double));
+
   Q.submit([&](sycl::handler& h){
     // global accessor
     sycl::accessor A_access{A_buffer, h};
 
     // 1D local accessor
-    auto A_local_access = sycl::local_accessor<double, 1>(SIZE, h);
+    auto A_local_access = sycl::local_accessor<double, 1>(local, h);
 
-    h.parallel_for(sycl::nd_range<1>{{SIZE}, {SIZE}}, [=](sycl::nd_item<1> it){
+    h.parallel_for<local_accessors_kernel>(sycl::nd_range<1>{{SIZE}, {local}}, [=](sycl::nd_item<1> it){
       auto idx = it.get_global_id();
       auto local_idx = it.get_local_id();
 
@@ -0,0 +1,378 @@
+#include <CL/sycl.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <assert.h>
+
+extern const size_t M = 256;
+extern const size_t N = 128;
+extern const size_t K = 512;
+
+extern constexpr int tile_size = 32;
+
+// prints device name
+template<typename Queue_type>
+void print_device(Queue_type& Q){
+  std::cout << "DEVICE: "
+            << Q.get_device().template get_info<sycl::info::device::name>()
+            << "\nVENDOR: "
+            << Q.get_device().template get_info<sycl::info::device::vendor>()
+            << "\n" << std::endl;
+}
+
+// element type codes stored in the file header
+enum class tile_dtype : uint32_t{
+  float32 = 1,
+  float64 = 2
+};
+
+template<typename Scalar_type>
+constexpr tile_dtype dtype_of(){
+  static_assert(std::is_same_v<Scalar_type, float> || std::is_same_v<Scalar_type, double>,
+                "tiled storage supports float and double");
+  return std::is_same_v<Scalar_type, float> ? tile_dtype::float32 : tile_dtype::float64;
+}
+
+// per tile flags, a zero tile has no payload in the file
+constexpr uint32_t tile_flag_zero = 1;
+
+// file layout
+//   - header
+//   - tile table, one entry per tile in tile row major order
+//   - tile payloads, each a row major tile_size x tile_size block padded
+//     with zeros at the matrix edges
+struct tiled_header{
+  char     magic[4];
+  uint32_t version;
+  uint64_t rows;
+  uint64_t cols;
+  uint32_t dtype;
+  uint32_t tile_size;
+};
+
+struct tile_entry{
+  uint64_t offset;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(tiled_header) == 32, "unexpected header padding");
+static_assert(sizeof(tile_entry) == 16, "unexpected tile entry padding");
+
+constexpr char tiled_magic[4] = {'S', 'T', 'M', 'F'};
+
+// writes a row major matrix in the tiled format, one tile at a time
+//   - space for the tile table is reserved after the header and the table
+//     is written once every payload is in place
+template<typename Scalar_type>
+void write_tiled_matrix(const std::string& path, const Scalar_type* A,
+                        size_t rows, size_t cols, size_t T){
+  std::ofstream out{path, std::ios::binary};
+  if(!out){
+    throw std::runtime_error("Cannot open " + path);
+  }
+
+  const size_t tile_rows = (rows + T - 1)/T;
+  const size_t tile_cols = (cols + T - 1)/T;
+
+  tiled_header header;
+  std::memcpy(header.magic, tiled_magic, 4);
+  header.version   = 1;
+  header.rows      = rows;
+  header.cols      = cols;
+  header.dtype     = static_cast<uint32_t>(dtype_of<Scalar_type>());
+  header.tile_size = T;
+
+  std::vector<tile_entry> table(tile_rows*tile_cols);
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(table.data()), table.size()*sizeof(tile_entry));
+
+  uint64_t offset = sizeof(tiled_header) + table.size()*sizeof(tile_entry);
+  std::vector<Scalar_type> tile(T*T);
+
+  for(size_t ti = 0; ti < tile_rows; ++ti){
+    for(size_t tj = 0; tj < tile_cols; ++tj){
+      std::fill(tile.begin(), tile.end(), Scalar_type{0});
+      bool zero = true;
+
+      for(size_t x = 0; x < T && ti*T + x < rows; ++x){
+        for(size_t y = 0; y < T && tj*T + y < cols; ++y){
+          tile[x*T + y] = A[(ti*T + x)*cols + tj*T + y];
+          zero = zero && tile[x*T + y] == Scalar_type{0};
+        }
+      }
+
+      tile_entry& entry = table[ti*tile_cols + tj];
+      entry.reserved = 0;
+
+      if(zero){
+        entry.offset = 0;
+        entry.flags  = tile_flag_zero;
+      }
+      else{
+        entry.offset = offset;
+        entry.flags  = 0;
+        offset += T*T*sizeof(Scalar_type);
+        out.write(reinterpret_cast<const char*>(tile.data()), tile.size()*sizeof(Scalar_type));
+      }
+    }
+  }
+
+  out.seekp(sizeof(tiled_header));
+  out.write(reinterpret_cast<const char*>(table.data()), table.size()*sizeof(tile_entry));
+
+  if(!out){
+    throw std::runtime_error("Cannot write " + path);
+  }
+}
+
+// reads individual tiles of a tiled matrix file
+template<typename Scalar_type>
+class tiled_matrix_reader{
+public:
+  tiled_matrix_reader(sycl::queue& Q, const std::string& path)
+    : Q{Q}, in{path, std::ios::binary}{
+    if(!in){
+      throw std::runtime_error("Cannot open " + path);
+    }
+
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if(!in || std::memcmp(header.magic, tiled_magic, 4) != 0 || header.version != 1){
+      throw std::runtime_error(path + " is not a tiled matrix file");
+    }
+
+    if(header.dtype != static_cast<uint32_t>(dtype_of<Scalar_type>())){
+      throw std::runtime_error(path + " has a different element type");
+    }
+
+    table.resize(tile_rows()*tile_cols());
+    in.read(reinterpret_cast<char*>(table.data()), table.size()*sizeof(tile_entry));
+
+    if(!in){
+      throw std::runtime_error(path + " has a truncated tile table");
+    }
+
+    staging[0] = sycl::malloc_host<Scalar_type>(tile_elements(), Q);
+    staging[1] = sycl::malloc_host<Scalar_type>(tile_elements(), Q);
+  }
+
+  ~tiled_matrix_reader(){
+    sycl::event::wait(pending);
+    sycl::free(staging[0], Q);
+    sycl::free(staging[1], Q);
+  }
+
+  tiled_matrix_reader(const tiled_matrix_reader&) = delete;
+  tiled_matrix_reader& operator=(const tiled_matrix_reader&) = delete;
+
+  size_t rows() const{ return header.rows; }
+  size_t cols() const{ return header.cols; }
+  size_t tile() const{ return header.tile_size; }
+  size_t tile_rows() const{ return (header.rows + header.tile_size - 1)/header.tile_size; }
+  size_t tile_cols() const{ return (header.cols + header.tile_size - 1)/header.tile_size; }
+  size_t tile_elements() const{ return size_t(header.tile_size)*header.tile_size; }
+
+  bool is_zero_tile(size_t ti, size_t tj) const{
+    return entry_of(ti, tj).flags & tile_flag_zero;
+  }
+
+  // reads one tile into host memory
+  void read_tile(size_t ti, size_t tj, Scalar_type* dst){
+    const tile_entry& entry = entry_of(ti, tj);
+
+    if(entry.flags & tile_flag_zero){
+      std::fill(dst, dst + tile_elements(), Scalar_type{0});
+      return;
+    }
+
+    in.seekg(entry.offset);
+    in.read(reinterpret_cast<char*>(dst), tile_elements()*sizeof(Scalar_type));
+
+    if(!in){
+      throw std::runtime_error("Cannot read tile (" + std::to_string(ti) + ", " + std::to_string(tj) + ")");
+    }
+  }
+
+  // streams one tile into device memory, the file read of the next tile
+  // overlaps the copy of this one, throws std::out_of_range for a tile
+  // outside the matrix
+  sycl::event stream_tile(size_t ti, size_t tj, Scalar_type* device_dst){
+    if(is_zero_tile(ti, tj)){
+      return Q.fill(device_dst, Scalar_type{0}, tile_elements());
+    }
+
+    // waiting for the copy that last used this staging slot
+    pending[slot].wait();
+
+    read_tile(ti, tj, staging[slot]);
+    pending[slot] = Q.memcpy(device_dst, staging[slot], tile_elements()*sizeof(Scalar_type));
+
+    sycl::event copied = pending[slot];
+    slot = 1 - slot;
+    return copied;
+  }
+
+private:
+  const tile_entry& entry_of(size_t ti, size_t tj) const{
+    if(ti >= tile_rows() || tj >= tile_cols()){
+      throw std::out_of_range("Tile (" + std::to_string(ti) + ", " + std::to_string(tj) +
+                              ") is outside the tile table");
+    }
+    return table[ti*tile_cols() + tj];
+  }
+
+  sycl::queue Q;
+  std::ifstream in;
+  tiled_header header;
+  std::vector<tile_entry> table;
+  Scalar_type* staging[2];
+  std::vector<sycl::event> pending = std::vector<sycl::event>(2);
+  int slot = 0;
+};
+
+// computes the single C tile (bi, bj) reading only the tiles it needs
+template<typename Queue_type, typename Scalar_type>
+void partial_tiled_matrix_multiply(Queue_type Q, tiled_matrix_reader<Scalar_type>& A_reader,
+                                                 tiled_matrix_reader<Scalar_type>& B_reader,
+                                                 size_t bi, size_t bj,
+                                                 std::vector<Scalar_type>& C_tile){
+  const size_t T = A_reader.tile();
+  const size_t k_tiles = A_reader.tile_cols();
+  const size_t tile_elements = T*T;
+
+  assert(B_reader.tile() == T && B_reader.tile_rows() == k_tiles);
+
+  Scalar_type *A_tiles = sycl::malloc_device<Scalar_type>(k_tiles*tile_elements, Q);
+  Scalar_type *B_tiles = sycl::malloc_device<Scalar_type>(k_tiles*tile_elements, Q);
+  Scalar_type *C_device = sycl::malloc_device<Scalar_type>(tile_elements, Q);
+
+  // streaming a tile row of A and a tile column of B
+  std::vector<sycl::event> loaded;
+  for(size_t kt = 0; kt < k_tiles; ++kt){
+    loaded.push_back(A_reader.stream_tile(bi, kt, A_tiles + kt*tile_elements));
+    loaded.push_back(B_reader.stream_tile(kt, bj, B_tiles + kt*tile_elements));
+  }
+
+  Q.submit([&](sycl::handler& h){
+    h.depends_on(loaded);
+
+    // matrix tile local access
+    auto tile_access = sycl::local_accessor<Scalar_type, 1>(T, h);
+
+    h.parallel_for(sycl::nd_range<2>{{T, T}, {1, T}}, [=](sycl::nd_item<2> it){
+      const int i = it.get_global_id()[0];
+      const int j = it.get_global_id()[1];
+
+      const int x = it.get_local_id()[1];
+
+      Scalar_type c_ij = 0;
+
+      for(size_t kt = 0; kt < k_tiles; ++kt){
+        const Scalar_type* A_tile = A_tiles + kt*tile_elements;
+        const Scalar_type* B_tile = B_tiles + kt*tile_elements;
+
+        tile_access[x] = A_tile[i*T + x];
+
+        sycl::group_barrier(it.get_group());
+
+        for(size_t k = 0; k < T; ++k){
+          c_ij += tile_access[k] * B_tile[k*T + j];
+        }
+
+        sycl::group_barrier(it.get_group());
+      }
+
+      C_device[i*T + j] = c_ij;
+    });
+  });
+
+  C_tile.resize(tile_elements);
+  Q.memcpy(C_tile.data(), C_device, tile_elements*sizeof(Scalar_type)).wait();
+
+  sycl::free(A_tiles, Q);
+  sycl::free(B_tiles, Q);
+  sycl::free(C_device, Q);
+}
+
+// verifying a single C tile
+template<typename Scalar_type>
+void check_tile(const std::vector<Scalar_type>& A, const std::vector<Scalar_type>& B,
+                const std::vector<Scalar_type>& C_tile, size_t bi, size_t bj,
+                Scalar_type tol){
+  for(size_t x = 0; x < tile_size; ++x){
+    for(size_t y = 0; y < tile_size; ++y){
+      const size_t i = bi*tile_size + x;
+      const size_t j = bj*tile_size + y;
+
+      double c_ij = 0.0;
+      for(size_t k = 0; k < K; ++k){
+        c_ij += A[i*K + k]*B[k*N + j];
+      }
+      assert(std::fabs(C_tile[x*tile_size + y] - c_ij) < tol);
+    }
+  }
+
+  std::cout << "The partial matrix multiply results are correct!" << std::endl;
+}
+
+int main(){
+  // establishing gpu for device queue
+  sycl::queue Q{sycl::gpu_selector_v};
+  print_device(Q);
+
+  // tolerance value
+  const double tol = 1.0E-6;
+
+  // creating input matrices
+  std::vector<double> A(M*K);
+  std::vector<double> B(K*N);
+
+  // creating a random distribution
+  std::default_random_engine generate(68);
+  std::uniform_real_distribution<double> distribution(0.0, 2.0);
+
+  auto random_number_generator = [&](){
+    return distribution(generate);
+  };
+
+  std::generate(A.begin(), A.end(), random_number_generator);
+  std::generate(B.begin(), B.end(), random_number_generator);
+
+  // zeroing the first tile row of A so its tiles are elided in the file
+  std::fill(A.begin(), A.begin() + tile_size*K, 0.0);
+
+  const std::string A_path = "tiled_A.bin";
+  const std::string B_path = "tiled_B.bin";
+
+  write_tiled_matrix(A_path, A.data(), M, K, tile_size);
+  write_tiled_matrix(B_path, B.data(), K, N, tile_size);
+
+  {
+    tiled_matrix_reader<double> A_reader{Q, A_path};
+    tiled_matrix_reader<double> B_reader{Q, B_path};
+
+    // computing a zero tile and a regular tile of C
+    std::vector<double> C_tile;
+
+    partial_tiled_matrix_multiply(Q, A_reader, B_reader, 0, 1, C_tile);
+    check_tile(A, B, C_tile, 0, 1, tol);
+
+    partial_tiled_matrix_multiply(Q, A_reader, B_reader, 3, 2, C_tile);
+    check_tile(A, B, C_tile, 3, 2, tol);
+  }
+
+  std::remove(A_path.c_str());
+  std::remove(B_path.c_str());
+
+  return 0;
+}